@@ -0,0 +1,26 @@
+// Runs the native benchmark scenarios and prints one line per scenario.
+// Usage: node bench/run.js [iterations] [buses] [devices]
+var bench = require('./../build/Release/w1direct_bench');
+
+var args = process.argv.slice(2).map(Number);
+var options = {};
+
+if (args[0]) options.iterations = args[0];
+if (args[1]) options.buses 		= args[1];
+if (args[2]) options.devices 	= args[2];
+
+var columns = ['name', 'iterations', 'wallMs', 'i2cTransactions', 'resets', 'bytesWritten', 'bytesRead', 'triplets'];
+
+function pad(value, width){
+	var str = String(value);
+	while (str.length < width) str = ' ' + str;
+	return str;
+}
+
+console.log(columns.map(function(c){ return pad(c, 16); }).join(''));
+
+bench.run(options).forEach(function(result){
+	console.log(columns.map(function(c){
+		return pad(c == 'wallMs' ? result[c].toFixed(3) : result[c], 16);
+	}).join(''));
+});
@@ -1,14 +1,29 @@
 {
+  "variables": {
+    "w1direct_sources": [
+      	"src/shared/util.cc", "src/shared/match.cc",  "src/shared/v8_helper.cc", "src/shared/histogram.cc",
+      	"src/master/master.cc", "src/master/statistics.cc", "src/master/ds2482.cc", "src/master/transport/smbus_transport.cc", "src/master/transport/i2c_transport.cc", "src/master/transport/ds2482_emulator.cc",
+      	"src/master/sim/simulated_master.cc", "src/master/sim/virtual_wire.cc", "src/master/sim/virtual_device.cc", "src/master/sim/virtual_ds18b20.cc",
+      	"src/master/sim/virtual_ds18s20.cc", "src/master/sim/virtual_ds2408.cc", "src/master/sim/virtual_ds1961.cc", "src/master/bus/bus.cc", "src/master/bus/search.cc",
+      	"src/device/device.cc", "src/device/ds18b20.cc", "src/device/ds18s20.cc", "src/device/ds1961.cc", "src/device/ds2408.cc",
+      	"src/device/unsupported.cc", "src/device/lib/crc.cc", "src/device/lib/temp.cc", "src/device/lib/sha33.cc",
+      	"src/controller/controller.cc", "src/controller/device_store.cc", "src/controller/temperature_engine.cc", "src/controller/read_planner.cc", "src/controller/read_group.cc"
+    ]
+  },
   "targets": [{
       "target_name": "w1direct",
       "cflags" : ["-std=c++11"],
       "sources": [
-      	"src/w1direct.cc", "src/manager.cc", "src/shared/util.cc", "src/shared/match.cc",  "src/shared/v8_helper.cc",
-      	"src/master/master.cc", "src/master/ds2482.cc", "src/master/bus/bus.cc", "src/master/bus/search.cc",
-      	"src/device/device.cc", "src/device/ds18b20.cc", "src/device/ds18s20.cc", "src/device/ds1961.cc", "src/device/ds2408.cc",
-      	"src/device/unsupported.cc", "src/device/lib/crc.cc", "src/device/lib/temp.cc", "src/device/lib/sha33.cc",
-      	"src/controller/controller.cc", "src/controller/device_store.cc",
-      	"src/api/api.cc", "src/api/broadcast.cc", "src/api/read.cc", "src/api/register.cc", "src/api/sync.cc", "src/api/update.cc"
+      	"src/w1direct.cc", "src/manager.cc", "<@(w1direct_sources)",
+      	"src/api/api.cc", "src/api/async.cc", "src/api/broadcast.cc", "src/api/find.cc", "src/api/get.cc", "src/api/read.cc", "src/api/register.cc", "src/api/sync.cc", "src/api/temperature.cc", "src/api/update.cc"
+      ],
+      "configurations": {'Release':{'msvs_settings':{'VCCLCompilerTool':{'ExceptionHandling':1}}}}
+    },
+    {
+      "target_name": "w1direct_bench",
+      "cflags" : ["-std=c++11"],
+      "sources": [
+      	"src/bench/w1direct_bench.cc", "src/bench/bench.cc", "src/bench/bench_rig.cc", "<@(w1direct_sources)"
       ],
       "configurations": {'Release':{'msvs_settings':{'VCCLCompilerTool':{'ExceptionHandling':1}}}}
     }
@@ -3,14 +3,30 @@
 #include "../shared/util.h"
 #include "../shared/match.h"
 #include "../controller/controller.h"
+#include "../controller/read_planner.h"
 #include <node.h>
 #include <string>
 #include <vector>
-#include <algorithm>
 
 using namespace v8;
 
 
+bool Api::AssertIdle(const Arguments& args){
+	bool idle = !node::ObjectWrap::Unwrap<Manager>(args.This())->asyncRunning;
+	Util::ThrowExceptionIf(!idle, "Manager is busy with an asynchronous call");
+
+	return idle;
+}
+
+
+bool Api::AssertCallback(const Arguments& args){
+	bool valid = args.Length() > 0 && V8ValueIsFromDataType(args[args.Length()-1], DT_FUNCTION);
+	Util::ThrowExceptionIf(!valid, "Last argument must be from data type 'function'");
+
+	return valid;
+}
+
+
 bool Api::AssertParamsFormat(const Arguments& args){
 	bool valid = args.Length() > 0 && V8ValueIsFromDataType(args[0], DT_OBJECT);
 	Util::ThrowExceptionIf(!valid, "First argument must be from data type 'object'");
@@ -77,6 +93,17 @@ bool Api::AssertDefaultParam(const Arguments& args, const char* param){
 
 
 
+//The params object itself is optional as well, a callback may take its place
+bool Api::AssertOptionalParam(const Arguments& args, const char* key, const char* dataType){
+
+	if (!HasParamsObject(args) || !V8ObjectHasKey(args[0], key))
+		return true;
+
+	return AssertParam(args, key, dataType);
+}
+
+
+
 bool Api::AssertMaster(const Arguments& args){
 	Controller *ctl = GetController(args);
 	std::string name = GetStrParam(args, DP_MASTER_NAME);
@@ -105,8 +132,11 @@ bool Api::AssertDevice(const Arguments& args){
 bool Api::AssertDevice(const Arguments& args, std::string* deviceId){
 	Controller *ctl = GetController(args);
 
-	bool deviceExists = ctl->GetDeviceStore()->HasDevice(deviceId);
-	bool deviceReady  = deviceExists && ctl->GetDeviceStore()->GetDevice(deviceId)->IsReady();
+	//malformed ids are not parsed, they do not exist either
+	bool validId	  = Match::PatternOrList(MP_DEVICE_ID, deviceId->c_str());
+	Device* device 	  = validId ? ctl->GetDeviceStore()->GetDevice(Util::HexStrToUInt64(deviceId)) : NULL;
+	bool deviceExists = device != NULL;
+	bool deviceReady  = deviceExists && device->IsReady();
 
 	Util::ThrowExceptionIf(!deviceExists,  "Device '%s' does not exist.", deviceId->c_str());
 	Util::ThrowExceptionIf(deviceExists && !deviceReady, "Device '%s' is not in READY state.", deviceId->c_str());
@@ -148,25 +178,33 @@ Bus* Api::GetBus(const Arguments& args){
 
 Device* Api::GetDevice(const Arguments& args){
 	std::string deviceId = GetStrParam(args, DP_DEVICE_ID);
-	return GetController(args)->GetDeviceStore()->GetDevice(&deviceId);
+	return GetController(args)->GetDeviceStore()->GetDevice(Util::HexStrToUInt64(&deviceId));
 }
 
 
 std::vector<Device*> Api::GetDevices(const Arguments& args){
+	std::vector<std::string> deviceIds = GetStrArrayParam(args, DP_DEVICE_IDS);
+	return FindDevices(GetController(args), &deviceIds);
+}
 
-	std::string deviceId;
-	std::vector<Device*> devices;
 
-	Controller *ctl = GetController(args);
-	Handle<Array> deviceIds = GetV8ArrayParam(args, DP_DEVICE_IDS);
+std::vector<Device*> Api::FindDevices(Controller* ctl, std::vector<std::string>* deviceIds){
+	return FindDevices(ctl, deviceIds, true);
+}
 
-	for (unsigned int i=0; i<deviceIds->Length(); ++i){
-		deviceId = V8ValueToStdString(deviceIds->Get(i));
-		devices.push_back(ctl->GetDeviceStore()->GetDevice(&deviceId));
-	}
 
-	//Sort by "overdrive->master->bus" for efficient read/write
-	std::sort(devices.begin(), devices.end());
+//Planned by "master->bus->speed" for efficient read/write
+std::vector<Device*> Api::FindDevices(Controller* ctl, std::vector<std::string>* deviceIds, bool plan){
+
+	ReadPlanner planner;
+	std::vector<Device*> devices;
+	std::vector<std::string>::iterator it;
+
+	for (it = deviceIds->begin(); it != deviceIds->end(); ++it)
+		devices.push_back(ctl->GetDeviceStore()->GetDevice(Util::HexStrToUInt64(&(*it))));
+
+	if (plan)
+		planner.Plan(&devices);
 
 	return devices;
 }
@@ -182,11 +220,33 @@ int Api::GetIntParam(const Arguments& args, const char* name){
 }
 
 
+bool Api::GetOptionalBoolParam(const Arguments& args, const char* name){
+	return HasParamsObject(args) && GetBoolFromV8Object(args[0], name);
+}
+
+
 Handle<Array> Api::GetV8ArrayParam(const Arguments& args, const char* name){
 	 return GetV8ArrayFromV8Object(args[0], name);
 }
 
 
+std::vector<std::string> Api::GetStrArrayParam(const Arguments& args, const char* name){
+
+	std::vector<std::string> values;
+	Handle<Array> array = GetV8ArrayParam(args, name);
+
+	for (unsigned int i=0; i<array->Length(); ++i)
+		values.push_back(V8ValueToStdString(array->Get(i)));
+
+	return values;
+}
+
+
+bool Api::HasParamsObject(const Arguments& args){
+	return args.Length() > 0 && args[0]->IsObject() && !args[0]->IsFunction();
+}
+
+
 Handle<Array> Api::DevicesToV8Array(std::vector<Device*> *devices, int deviceDataType){
 	Handle<Array> array = Array::New((int) devices->size());
 
@@ -206,3 +266,12 @@ Handle<Object> Api::DevicesToV8Object(std::vector<Device*> *devices, int deviceD
 	return result;
 }
 
+
+Handle<Object> Api::DevicesToV8Object(std::vector<Device*> *devices, int deviceDataType, std::vector<bool> *verified){
+	Handle<Object> result = Object::New();
+
+	for (unsigned int i = 0; i != devices->size(); ++i)
+		AddPairToV8Object(result, devices->at(i)->GetStrId()->c_str(), devices->at(i)->ToV8Object(deviceDataType, false, verified->at(i)));
+
+	return result;
+}
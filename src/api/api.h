@@ -21,11 +21,14 @@ using namespace v8;
 class Api : public V8Helper {
 
 protected:
+   static bool  	  	 AssertIdle(const Arguments&);
+   static bool  	  	 AssertCallback(const Arguments&);
    static bool  	  	 AssertParamsFormat(const Arguments&);
    static bool  	  	 AssertParam(const Arguments&, const char*, const char*);
    static bool  	  	 AssertParamIn(const Arguments&, const char*, const char*);
    static bool  	  	 AssertArrayParamIn(const Arguments&, const char*, const char*);
    static bool 		  	 AssertDefaultParam(const Arguments&, const char*);
+   static bool 		  	 AssertOptionalParam(const Arguments&, const char*, const char*);
 
    static bool 		  	 AssertMaster(const Arguments&);
    static bool 		  	 AssertBus(const Arguments&);
@@ -38,13 +41,20 @@ protected:
    static Bus*        	 GetBus(const Arguments&);
    static Device* 		 GetDevice(const Arguments&);
    static DEVICE_VECTOR  GetDevices(const Arguments&);
+   static DEVICE_VECTOR  FindDevices(Controller*, std::vector<std::string>*);
+   static DEVICE_VECTOR  FindDevices(Controller*, std::vector<std::string>*, bool);
 
    static std::string 	 GetStrParam(const Arguments&, const char*);
    static int 		  	 GetIntParam(const Arguments&, const char*);
+   static bool 		  	 GetOptionalBoolParam(const Arguments&, const char*);
    static Handle<Array>	 GetV8ArrayParam(const Arguments&s, const char*);
+   static std::vector<std::string> GetStrArrayParam(const Arguments&, const char*);
+
+   static bool 		  	 HasParamsObject(const Arguments&);
 
    static Handle<Array>  DevicesToV8Array(std::vector<Device*>*,  int);
    static Handle<Object> DevicesToV8Object(std::vector<Device*>*, int);
+   static Handle<Object> DevicesToV8Object(std::vector<Device*>*, int, std::vector<bool>*);
 
 };
 
@@ -0,0 +1,144 @@
+#include "async.h"
+#include "../manager.h"
+#include "../shared/util.h"
+#include "../shared/match.h"
+#include <node.h>
+#include <uv.h>
+#include <stdarg.h>
+#include <string>
+
+using namespace v8;
+
+#define MAX_ERROR_MSG_LEN 100
+
+
+AsyncJob::AsyncJob(void)
+	:controller(NULL), timer(NULL)
+{
+	request.data = this;
+}
+
+
+AsyncJob::~AsyncJob(void){
+	delete timer;
+	manager.Dispose();
+	callback.Dispose();
+}
+
+
+//Same message format as Util::ThrowExceptionIf, but safe on worker threads
+void AsyncJob::SetErrorIf(bool isError, const char* format, ...){
+
+	if (isError && error.empty()){
+		char msg[MAX_ERROR_MSG_LEN+1];
+		va_list args;
+		va_start(args, format);
+		vsnprintf(msg, MAX_ERROR_MSG_LEN, format, args);
+		va_end(args);
+		error = msg;
+	}
+
+}
+
+
+bool AsyncJob::HasError(void){
+	return !error.empty();
+}
+
+
+//Devices are checked again on execution, an earlier job may have removed them
+bool AsyncJob::AssertDevice(std::string* deviceId){
+
+	//malformed ids are not parsed, they do not exist either
+	bool validId	  = Match::PatternOrList(MP_DEVICE_ID, deviceId->c_str());
+	Device* device 	  = validId ? controller->GetDeviceStore()->GetDevice(Util::HexStrToUInt64(deviceId)) : NULL;
+	bool deviceExists = device != NULL;
+	bool deviceReady  = deviceExists && device->IsReady();
+
+	SetErrorIf(!deviceExists,  "Device '%s' does not exist.", deviceId->c_str());
+	SetErrorIf(deviceExists && !deviceReady, "Device '%s' is not in READY state.", deviceId->c_str());
+
+	return deviceReady;
+}
+
+
+//Groups are checked again on execution, an earlier sync may have
+//invalidated them
+bool AsyncJob::AssertReadGroup(int groupId, bool mustBeValid){
+
+	bool groupExists = controller->HasReadGroup(groupId);
+	bool groupValid  = groupExists && controller->GetReadGroup(groupId)->IsValid();
+
+	SetErrorIf(!groupExists, "Read group '%d' does not exist.", groupId);
+	SetErrorIf(groupExists && mustBeValid && !groupValid, "Read group '%d' is invalid, a device was removed by a sync.", groupId);
+
+	return groupExists && (groupValid || !mustBeValid);
+}
+
+
+
+Handle<Value> Async::Queue(const Arguments& args, AsyncJob* job){
+
+	Manager* manager = node::ObjectWrap::Unwrap<Manager>(args.This());
+	Handle<Function> callback = Handle<Function>::Cast(args[args.Length()-1]);
+
+	job->controller = manager->controller;
+	job->manager 	= Persistent<Object>::New(args.This());
+	job->callback	= Persistent<Function>::New(callback);
+
+	//the latency of the call ends with the callback
+	job->timer = new LatencyTimer(manager->callLatencies);
+	manager->callLatencies = NULL;
+
+	manager->asyncJobs.push_back(job);
+	StartNext(manager);
+
+	return Undefined();
+}
+
+
+//private
+
+void Async::StartNext(Manager* manager){
+
+	if (manager->asyncRunning || manager->asyncJobs.empty())
+		return;
+
+	manager->asyncRunning = true;
+	AsyncJob* job = manager->asyncJobs.front();
+	uv_queue_work(uv_default_loop(), &job->request, Work, AfterWork);
+}
+
+
+void Async::Work(uv_work_t* request){
+	AsyncJob* job = static_cast<AsyncJob*>(request->data);
+	job->Execute();
+}
+
+
+void Async::AfterWork(uv_work_t* request, int status){
+	HandleScope scope;
+
+	AsyncJob* job = static_cast<AsyncJob*>(request->data);
+	Manager* manager = node::ObjectWrap::Unwrap<Manager>(job->manager);
+
+	//sync calls are allowed again inside the callback
+	manager->asyncJobs.pop_front();
+	manager->asyncRunning = false;
+
+	Handle<Value> argv[2];
+	argv[0] = job->HasError() ? Exception::Error(String::New(job->error.c_str())) : (Handle<Value>) Null();
+	argv[1] = job->HasError() ? (Handle<Value>) Undefined() : job->BuildResult();
+
+	delete job->timer;
+	job->timer = NULL;
+
+	TryCatch tryCatch;
+	job->callback->Call(Context::GetCurrent()->Global(), 2, argv);
+
+	StartNext(manager);
+	delete job;
+
+	if (tryCatch.HasCaught())
+		node::FatalException(tryCatch);
+}
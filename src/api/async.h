@@ -0,0 +1,60 @@
+#ifndef ASYNC_H
+#define ASYNC_H
+
+#include "api.h"
+#include "../shared/histogram.h"
+#include <node.h>
+#include <uv.h>
+#include <string>
+
+using namespace v8;
+
+class Manager;
+
+// Unit of work for the "...Async" API variants.
+// Execute() runs on a libuv worker thread and must not touch V8,
+// BuildResult() runs on the loop thread once Execute() has finished.
+class AsyncJob {
+
+  public:
+	AsyncJob(void);
+	virtual ~AsyncJob(void);
+
+	virtual void Execute(void) = 0;
+	virtual Handle<Value> BuildResult(void){return Undefined();}
+
+	void SetErrorIf(bool, const char*, ...);
+	bool HasError(void);
+	bool AssertDevice(std::string*);
+	bool AssertReadGroup(int, bool);
+
+	Controller* controller;
+	Persistent<Object> manager;
+	Persistent<Function> callback;
+	LatencyTimer* timer;
+	uv_work_t request;
+
+  private:
+	std::string error;
+
+	friend class Async;
+};
+
+
+// Jobs of one manager are executed one after another, so the
+// controller and its devices are never accessed concurrently.
+class Async : public Api {
+
+  public:
+	static Handle<Value> Queue(const Arguments&, AsyncJob*);
+
+
+  private:
+	static void StartNext(Manager*);
+	static void Work(uv_work_t*);
+	static void AfterWork(uv_work_t*, int);
+
+};
+
+
+#endif
@@ -1,4 +1,5 @@
 #include "broadcast.h"
+#include "async.h"
 
 using namespace v8;
 
@@ -7,10 +8,43 @@ using namespace v8;
 #define CMD_TCONV	0x44
 
 
+class BusCommandJob : public AsyncJob {
+
+  public:
+	BusCommandJob(Bus* bus) : bus(bus) {}
+	void Execute(void){ Broadcast::ExecuteBusCommand(bus); }
+
+  private:
+	Bus* bus;
+};
+
+
+
 Handle<Value> Broadcast::BusCommand(const Arguments& args) {
 	HandleScope scope;
 
-	bool validArgs =
+	if (AssertIdle(args) && BusCommandAssertParams(args))
+		ExecuteBusCommand(GetBus(args));
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Broadcast::BusCommandAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (BusCommandAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new BusCommandJob(GetBus(args)));
+
+	return scope.Close(Undefined());
+}
+
+
+//private
+
+bool Broadcast::BusCommandAssertParams(const Arguments& args){
+
+	return
 		AssertParamsFormat(args) 				     &&
 		AssertDefaultParam(args, DP_MASTER_NAME)     &&
 		AssertDefaultParam(args, DP_BUS_NUMBER)      &&
@@ -19,14 +53,13 @@ Handle<Value> Broadcast::BusCommand(const Arguments& args) {
 		AssertMaster(args)						     &&
 		AssertBus(args);
 
-
-	if (validArgs){
-		GetBus(args)->SetOverdriveSpeed(false);
-		GetBus(args)->BroadcastCommand(CMD_TCONV);
-	}
+}
 
 
-	return scope.Close(Undefined());
+//Parasite powered sensors convert with the strong pullup of the bus
+void Broadcast::ExecuteBusCommand(Bus* bus){
+	bus->SetOverdriveSpeed(false);
+	bus->BroadcastPowerCommand(CMD_TCONV);
 }
 
 
@@ -11,8 +11,15 @@ class Broadcast: public Api   {
 
 public:
   static Handle<Value> BusCommand(const Arguments&);
+  static Handle<Value> BusCommandAsync(const Arguments&);
 
 
+private:
+  static bool BusCommandAssertParams(const Arguments&);
+  static void ExecuteBusCommand(Bus*);
+
+  friend class BusCommandJob;
+
 };
 
 
@@ -0,0 +1,141 @@
+#include "find.h"
+#include "async.h"
+#include "../controller/controller.h"
+#include "../master/bus/search.h"
+#include "../shared/util.h"
+#include <node.h>
+#include <vector>
+#include <stdint.h>
+
+#define CP_FAMILY_CODE "familyCode"
+#define CP_ALARM_ONLY  "alarmOnly"
+
+using namespace v8;
+
+
+class FindJob : public AsyncJob {
+
+  public:
+	FindJob(Bus* bus, int familyCode, bool alarmOnly)
+		: bus(bus), familyCode(familyCode), alarmOnly(alarmOnly) {}
+
+
+	void Execute(void){
+		if (bus != NULL)
+			deviceIds = controller->FindBusDevices(bus, familyCode, alarmOnly);
+		else
+			deviceIds = controller->FindAllDevices(familyCode, alarmOnly);
+	}
+
+
+	Handle<Value> BuildResult(void){
+		return Find::DeviceIdsToV8Array(&deviceIds);
+	}
+
+
+  private:
+	Bus* bus;
+	int  familyCode;
+	bool alarmOnly;
+	std::vector<uint64_t> deviceIds;
+};
+
+
+
+Handle<Value> Find::AllDevices(const Arguments& args) {
+  HandleScope scope;
+
+  if (AssertIdle(args) && AllDevicesAssertParams(args)){
+	  std::vector<uint64_t> deviceIds = GetController(args)->FindAllDevices(GetFamilyCodeParam(args), GetOptionalBoolParam(args, CP_ALARM_ONLY));
+	  return scope.Close(DeviceIdsToV8Array(&deviceIds));
+  }
+
+  return scope.Close(Undefined());
+}
+
+
+
+Handle<Value> Find::BusDevices(const Arguments& args) {
+  HandleScope scope;
+
+  if (AssertIdle(args) && BusDevicesAssertParams(args)){
+	  std::vector<uint64_t> deviceIds = GetController(args)->FindBusDevices(GetBus(args), GetFamilyCodeParam(args), GetOptionalBoolParam(args, CP_ALARM_ONLY));
+	  return scope.Close(DeviceIdsToV8Array(&deviceIds));
+  }
+
+  return scope.Close(Undefined());
+}
+
+
+
+Handle<Value> Find::AllDevicesAsync(const Arguments& args) {
+  HandleScope scope;
+
+  if (AllDevicesAssertParams(args) && AssertCallback(args))
+	  Async::Queue(args, new FindJob(NULL, GetFamilyCodeParam(args), GetOptionalBoolParam(args, CP_ALARM_ONLY)));
+
+  return scope.Close(Undefined());
+}
+
+
+
+Handle<Value> Find::BusDevicesAsync(const Arguments& args) {
+  HandleScope scope;
+
+  if (BusDevicesAssertParams(args) && AssertCallback(args))
+	  Async::Queue(args, new FindJob(GetBus(args), GetFamilyCodeParam(args), GetOptionalBoolParam(args, CP_ALARM_ONLY)));
+
+  return scope.Close(Undefined());
+}
+
+
+
+//private
+
+bool Find::AllDevicesAssertParams(const Arguments& args){
+  return
+	AssertOptionalParam(args, CP_FAMILY_CODE, DT_NUMBER) &&
+	AssertOptionalParam(args, CP_ALARM_ONLY, DT_BOOLEAN) &&
+	AssertFamilyCodeParam(args);
+}
+
+
+bool Find::BusDevicesAssertParams(const Arguments& args){
+
+  return
+	AssertParamsFormat(args) &&
+	AssertDefaultParam(args, DP_MASTER_NAME) &&
+	AssertDefaultParam(args, DP_BUS_NUMBER)  &&
+	AssertOptionalParam(args, CP_FAMILY_CODE, DT_NUMBER) &&
+	AssertOptionalParam(args, CP_ALARM_ONLY, DT_BOOLEAN) &&
+	AssertFamilyCodeParam(args) &&
+	AssertMaster(args) &&
+	AssertBus(args);
+
+}
+
+
+//No device has family code 0x00
+bool Find::AssertFamilyCodeParam(const Arguments& args){
+	int familyCode = GetFamilyCodeParam(args);
+	bool valid = familyCode == SEARCH_ALL_FAMILIES || (familyCode > 0 && familyCode <= 0xFF);
+	Util::ThrowExceptionIf(!valid, "Param '%s' must be a family code from 1 to 255", CP_FAMILY_CODE);
+
+	return valid;
+}
+
+
+int Find::GetFamilyCodeParam(const Arguments& args){
+	return HasParamsObject(args) && V8ObjectHasKey(args[0], CP_FAMILY_CODE) ? GetIntParam(args, CP_FAMILY_CODE) : SEARCH_ALL_FAMILIES;
+}
+
+
+Handle<Array> Find::DeviceIdsToV8Array(std::vector<uint64_t>* deviceIds){
+
+	Handle<Array> list = Array::New(deviceIds->size());
+
+	for (unsigned int i=0; i < deviceIds->size(); i++)
+		list->Set(i, String::New(Util::UInt64ToHexStr(deviceIds->at(i)).c_str()));
+
+	return list;
+}
@@ -0,0 +1,34 @@
+#ifndef FIND_H
+#define FIND_H
+
+#include "api.h"
+#include <node.h>
+#include <vector>
+#include <stdint.h>
+
+using namespace v8;
+
+
+class Find: public Api   {
+
+public:
+  static Handle<Value> AllDevices(const Arguments&);
+  static Handle<Value> BusDevices(const Arguments&);
+
+  static Handle<Value> AllDevicesAsync(const Arguments&);
+  static Handle<Value> BusDevicesAsync(const Arguments&);
+
+
+private:
+  static bool AllDevicesAssertParams(const Arguments&);
+  static bool BusDevicesAssertParams(const Arguments&);
+  static bool AssertFamilyCodeParam(const Arguments&);
+  static int  GetFamilyCodeParam(const Arguments&);
+  static Handle<Array> DeviceIdsToV8Array(std::vector<uint64_t>*);
+
+  friend class FindJob;
+
+};
+
+
+#endif
@@ -0,0 +1,226 @@
+#include "get.h"
+#include "async.h"
+#include "../master/master.h"
+#include "../master/statistics.h"
+#include "../shared/histogram.h"
+#include "../manager.h"
+#include <node.h>
+#include <vector>
+#include <map>
+#include <string>
+
+using namespace v8;
+
+#define CP_RESET "reset"
+
+//Names of the PRIM_... primitives
+static const char* primitiveNames[PRIM_COUNT] = {
+	"W1Reset", "W1WriteByte", "W1ReadByte", "W1WriteBlock", "W1ReadBlock", "W1Triplet", "SelectBus", "W1SingleBit"
+};
+
+
+class StatisticsJob : public AsyncJob {
+
+  public:
+	StatisticsJob(bool reset) : reset(reset) {}
+
+
+	//counters are read after the previous jobs, without bus access
+	void Execute(void){}
+
+
+	Handle<Value> BuildResult(void){
+		return Get::StatisticsToV8Object(controller, reset);
+	}
+
+
+  private:
+	bool reset;
+};
+
+
+
+class LatenciesJob : public AsyncJob {
+
+  public:
+	LatenciesJob(bool reset) : reset(reset) {}
+
+
+	void Execute(void){}
+
+
+	Handle<Value> BuildResult(void){
+		return Get::LatenciesToV8Object(node::ObjectWrap::Unwrap<Manager>(manager), reset);
+	}
+
+
+  private:
+	bool reset;
+};
+
+
+
+Handle<Value> Get::Statistics(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && StatisticsAssertParams(args))
+		return scope.Close(StatisticsToV8Object(GetController(args), GetOptionalBoolParam(args, CP_RESET)));
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Get::StatisticsAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (StatisticsAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new StatisticsJob(GetOptionalBoolParam(args, CP_RESET)));
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Get::Latencies(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && LatenciesAssertParams(args))
+		return scope.Close(LatenciesToV8Object(node::ObjectWrap::Unwrap<Manager>(args.This()), GetOptionalBoolParam(args, CP_RESET)));
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Get::LatenciesAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (LatenciesAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new LatenciesJob(GetOptionalBoolParam(args, CP_RESET)));
+
+	return scope.Close(Undefined());
+}
+
+
+//private
+
+bool Get::StatisticsAssertParams(const Arguments& args){
+	return AssertOptionalParam(args, CP_RESET, DT_BOOLEAN);
+}
+
+
+//One entry per master, counters are set back to 0 after reading on reset
+Handle<Object> Get::StatisticsToV8Object(Controller* controller, bool reset){
+
+	Handle<Object> result = Object::New();
+	std::map<std::string, Master*>::iterator itM;
+
+	for (itM = controller->masters.begin(); itM != controller->masters.end(); ++itM){
+		AddPairToV8Object(result, itM->first.c_str(), MasterStatisticsToV8Object(itM->second));
+
+		if (reset){
+			std::vector<Bus*>* buses = itM->second->GetBuses();
+			itM->second->GetStatistics()->Reset();
+
+			for (unsigned int i=0; i < buses->size(); i++)
+				buses->at(i)->GetStatistics()->Reset();
+		}
+	}
+
+	return result;
+}
+
+
+//Master counters include the counters of all its buses
+Handle<Object> Get::MasterStatisticsToV8Object(Master* master){
+
+	Handle<Object> result = Object::New();
+	Handle<Array> busList = Array::New();
+	std::vector<Bus*>* buses = master->GetBuses();
+	::Statistics total = *master->GetStatistics();
+
+	for (unsigned int i=0; i < buses->size(); i++){
+		Handle<Object> busResult = Object::New();
+		::Statistics* busStatistics = buses->at(i)->GetStatistics();
+
+		AddPairToV8Object(busResult, "bus", buses->at(i)->GetNumber());
+		AddCountersToV8Object(busResult, busStatistics);
+		busList->Set(i, busResult);
+
+		total.Add(busStatistics);
+	}
+
+	AddCountersToV8Object(result, &total);
+	AddPairToV8Object(result, "channelSelects", Number::New(total.channelSelects));
+	AddPairToV8Object(result, "configWrites", 	Number::New(total.configWrites));
+	AddPairToV8Object(result, "statusPolls", 	Number::New(total.statusPolls));
+	AddPairToV8Object(result, "buses", busList);
+
+	return result;
+}
+
+
+void Get::AddCountersToV8Object(Handle<Object> target, ::Statistics* statistics){
+	AddPairToV8Object(target, "resets", 	  Number::New(statistics->resets));
+	AddPairToV8Object(target, "overdriveResets", Number::New(statistics->overdriveResets));
+	AddPairToV8Object(target, "bytesWritten", Number::New(statistics->bytesWritten));
+	AddPairToV8Object(target, "bytesRead", 	  Number::New(statistics->bytesRead));
+	AddPairToV8Object(target, "triplets", 	  Number::New(statistics->triplets));
+	AddPairToV8Object(target, "crcFailures",  Number::New(statistics->crcFailures));
+	AddPairToV8Object(target, "strongPullups", Number::New(statistics->strongPullups));
+	AddPairToV8Object(target, "busyTimeUs",   Number::New(statistics->busyMicros));
+}
+
+
+bool Get::LatenciesAssertParams(const Arguments& args){
+	return AssertOptionalParam(args, CP_RESET, DT_BOOLEAN);
+}
+
+
+//API functions appear after their first call, primitives per master
+Handle<Object> Get::LatenciesToV8Object(Manager* manager, bool reset){
+
+	Handle<Object> result  = Object::New();
+	Handle<Object> api 	   = Object::New();
+	Handle<Object> masters = Object::New();
+	std::map<std::string, Histogram>::iterator itA;
+	std::map<std::string, Master*>::iterator itM;
+
+	for (itA = manager->apiLatencies.begin(); itA != manager->apiLatencies.end(); ++itA){
+		AddPairToV8Object(api, itA->first.c_str(), HistogramToV8Object(&itA->second));
+
+		if (reset)
+			itA->second.Reset();
+	}
+
+	for (itM = manager->controller->masters.begin(); itM != manager->controller->masters.end(); ++itM){
+		Handle<Object> primitives = Object::New();
+
+		for (int i=0; i<PRIM_COUNT; i++){
+			AddPairToV8Object(primitives, primitiveNames[i], HistogramToV8Object(itM->second->GetLatencies(i)));
+
+			if (reset)
+				itM->second->GetLatencies(i)->Reset();
+		}
+
+		AddPairToV8Object(masters, itM->first.c_str(), primitives);
+	}
+
+	AddPairToV8Object(result, "api", 	 api);
+	AddPairToV8Object(result, "masters", masters);
+
+	return result;
+}
+
+
+//Values in us
+Handle<Object> Get::HistogramToV8Object(Histogram* histogram){
+
+	Handle<Object> result = Object::New();
+
+	AddPairToV8Object(result, "count", Number::New(histogram->GetCount()));
+	AddPairToV8Object(result, "p50",   Number::New(histogram->Percentile(50)));
+	AddPairToV8Object(result, "p95",   Number::New(histogram->Percentile(95)));
+	AddPairToV8Object(result, "p99",   Number::New(histogram->Percentile(99)));
+	AddPairToV8Object(result, "max",   Number::New(histogram->GetMax()));
+
+	return result;
+}
@@ -0,0 +1,40 @@
+#ifndef GET_H
+#define GET_H
+
+#include "api.h"
+#include "../master/statistics.h"
+#include "../shared/histogram.h"
+#include <node.h>
+
+using namespace v8;
+
+
+class Manager;
+
+
+class Get: public Api   {
+
+public:
+  static Handle<Value> Statistics(const Arguments&);
+  static Handle<Value> StatisticsAsync(const Arguments&);
+  static Handle<Value> Latencies(const Arguments&);
+  static Handle<Value> LatenciesAsync(const Arguments&);
+
+
+private:
+  static bool StatisticsAssertParams(const Arguments&);
+  static Handle<Object> StatisticsToV8Object(Controller*, bool);
+  static Handle<Object> MasterStatisticsToV8Object(Master*);
+  static void AddCountersToV8Object(Handle<Object>, ::Statistics*);
+
+  static bool LatenciesAssertParams(const Arguments&);
+  static Handle<Object> LatenciesToV8Object(Manager*, bool);
+  static Handle<Object> HistogramToV8Object(Histogram*);
+
+  friend class StatisticsJob;
+  friend class LatenciesJob;
+
+};
+
+
+#endif
@@ -1,22 +1,161 @@
 #include "read.h"
+#include "async.h"
 #include "../shared/util.h"
 #include <vector>
-#include <algorithm>
+#include <string>
 
 using namespace v8;
 
 #define CP_FIELDS "fields"
 #define CV_FIELDS "values|properties|connection"
+#define CP_GROUP_ID "groupId"
+
+
+class DevicesByIdJob : public AsyncJob {
+
+  public:
+	DevicesByIdJob(std::vector<std::string> deviceIds, int fields)
+		: deviceIds(deviceIds), fields(fields) {}
+
+
+	void Execute(void){
+		std::vector<std::string>::iterator it;
+
+		for (it = deviceIds.begin(); it != deviceIds.end(); ++it)
+			if (!AssertDevice(&(*it))) return;
+
+		devices = Read::FindDevices(controller, &deviceIds);
+
+		for (unsigned int i = 0; i != devices.size(); ++i)
+			verified.push_back(devices[i]->ReadAndVerify(fields));
+	}
+
+
+	Handle<Value> BuildResult(void){
+		return Read::DevicesToV8Object(&devices, fields, &verified);
+	}
+
+
+  private:
+	std::vector<std::string> deviceIds;
+	std::vector<Device*> devices;
+	std::vector<bool> verified;
+	int fields;
+};
+
+
+
+class PlanDevicesByIdJob : public AsyncJob {
+
+  public:
+	PlanDevicesByIdJob(std::vector<std::string> deviceIds) : deviceIds(deviceIds) {}
+
+
+	//planning needs no bus access, the devices are only checked here
+	void Execute(void){
+		std::vector<std::string>::iterator it;
+
+		for (it = deviceIds.begin(); it != deviceIds.end(); ++it)
+			if (!AssertDevice(&(*it))) return;
+	}
+
+
+	Handle<Value> BuildResult(void){
+		return Read::PlanToV8Object(controller, &deviceIds);
+	}
+
+
+  private:
+	std::vector<std::string> deviceIds;
+};
+
+
+
+class PrepareGroupJob : public AsyncJob {
+
+  public:
+	PrepareGroupJob(std::vector<std::string> deviceIds, int fields)
+		: deviceIds(deviceIds), fields(fields), groupId(0) {}
+
+
+	void Execute(void){
+		std::vector<std::string>::iterator it;
+
+		for (it = deviceIds.begin(); it != deviceIds.end(); ++it)
+			if (!AssertDevice(&(*it))) return;
+
+		std::vector<Device*> devices = Read::FindDevices(controller, &deviceIds, false);
+		groupId = controller->AddReadGroup(new ReadGroup(&devices, fields));
+	}
+
+
+	Handle<Value> BuildResult(void){
+		return Number::New(groupId);
+	}
+
+
+  private:
+	std::vector<std::string> deviceIds;
+	int fields;
+	int groupId;
+};
+
+
+
+class GroupJob : public AsyncJob {
+
+  public:
+	GroupJob(int groupId) : groupId(groupId), group(NULL) {}
+
+
+	void Execute(void){
+		if (!AssertReadGroup(groupId, true)) return;
+
+		group = controller->GetReadGroup(groupId);
+		group->PlanIfSpeedChanged();
+
+		for (unsigned int i = 0; i != group->GetDevices()->size(); ++i)
+			verified.push_back(group->GetDevices()->at(i)->ReadAndVerify(group->GetFields()));
+	}
+
+
+	Handle<Value> BuildResult(void){
+		return Read::DevicesToV8Object(group->GetDevices(), group->GetFields(), &verified);
+	}
+
+
+  private:
+	int groupId;
+	ReadGroup* group;
+	std::vector<bool> verified;
+};
+
+
+
+class ReleaseGroupJob : public AsyncJob {
+
+  public:
+	ReleaseGroupJob(int groupId) : groupId(groupId) {}
+
+
+	void Execute(void){
+		if (AssertReadGroup(groupId, false))
+			controller->RemoveReadGroup(groupId);
+	}
+
+
+  private:
+	int groupId;
+};
+
 
 
 Handle<Value> Read::DevicesById(const Arguments& args) {
 	HandleScope scope;
 
 	bool validArgs =
-	  AssertParamsFormat(args) 				  	 	  &&
-  	  AssertDefaultParam(args, DP_DEVICE_IDS) 	 	  &&
-  	  AssertParam(args, CP_FIELDS, DT_ARRAY)   	 	  &&
-  	  AssertArrayParamIn(args, CP_FIELDS, CV_FIELDS)  &&
+	  AssertIdle(args) 						  &&
+	  DevicesByIdAssertParams(args) 		  &&
 	  AssertDevices(args);
 
 
@@ -31,8 +170,153 @@ Handle<Value> Read::DevicesById(const Arguments& args) {
 }
 
 
+Handle<Value> Read::DevicesByIdAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (DevicesByIdAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new DevicesByIdJob(GetStrArrayParam(args, DP_DEVICE_IDS), GetFieldBitMask(args)));
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Read::PlanDevicesById(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && PlanDevicesByIdAssertParams(args) && AssertDevices(args)){
+		std::vector<std::string> deviceIds = GetStrArrayParam(args, DP_DEVICE_IDS);
+		return scope.Close(PlanToV8Object(GetController(args), &deviceIds));
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Read::PlanDevicesByIdAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (PlanDevicesByIdAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new PlanDevicesByIdJob(GetStrArrayParam(args, DP_DEVICE_IDS)));
+
+	return scope.Close(Undefined());
+}
+
+
+//The group is resolved and planned once, the returned id is passed
+//to readGroup
+Handle<Value> Read::PrepareGroup(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && DevicesByIdAssertParams(args) && AssertDevices(args)){
+		std::vector<std::string> deviceIds = GetStrArrayParam(args, DP_DEVICE_IDS);
+		std::vector<Device*> devices = FindDevices(GetController(args), &deviceIds, false);
+		int groupId = GetController(args)->AddReadGroup(new ReadGroup(&devices, GetFieldBitMask(args)));
+
+		return scope.Close(Number::New(groupId));
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Read::PrepareGroupAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (DevicesByIdAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new PrepareGroupJob(GetStrArrayParam(args, DP_DEVICE_IDS), GetFieldBitMask(args)));
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Read::Group(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && GroupAssertParams(args) && AssertReadGroup(args, true)){
+		ReadGroup* group = GetController(args)->GetReadGroup(GetIntParam(args, CP_GROUP_ID));
+		group->PlanIfSpeedChanged();
+		return scope.Close(DevicesToV8Object(group->GetDevices(), group->GetFields()));
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Read::GroupAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (GroupAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new GroupJob(GetIntParam(args, CP_GROUP_ID)));
+
+	return scope.Close(Undefined());
+}
+
+
+//Invalid groups are released as well
+Handle<Value> Read::ReleaseGroup(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && GroupAssertParams(args) && AssertReadGroup(args, false))
+		GetController(args)->RemoveReadGroup(GetIntParam(args, CP_GROUP_ID));
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Read::ReleaseGroupAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (GroupAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new ReleaseGroupJob(GetIntParam(args, CP_GROUP_ID)));
+
+	return scope.Close(Undefined());
+}
+
+
 //private
 
+bool Read::DevicesByIdAssertParams(const Arguments& args){
+
+	return
+	  AssertParamsFormat(args) 				  	 	  &&
+  	  AssertDefaultParam(args, DP_DEVICE_IDS) 	 	  &&
+  	  AssertParam(args, CP_FIELDS, DT_ARRAY)   	 	  &&
+  	  AssertArrayParamIn(args, CP_FIELDS, CV_FIELDS);
+
+}
+
+
+bool Read::PlanDevicesByIdAssertParams(const Arguments& args){
+
+	return
+	  AssertParamsFormat(args) &&
+	  AssertDefaultParam(args, DP_DEVICE_IDS);
+
+}
+
+
+bool Read::GroupAssertParams(const Arguments& args){
+
+	return
+	  AssertParamsFormat(args) &&
+	  AssertParam(args, CP_GROUP_ID, DT_NUMBER);
+
+}
+
+
+bool Read::AssertReadGroup(const Arguments& args, bool mustBeValid){
+
+	int groupId		 = GetIntParam(args, CP_GROUP_ID);
+	bool groupExists = GetController(args)->HasReadGroup(groupId);
+	bool groupValid  = groupExists && GetController(args)->GetReadGroup(groupId)->IsValid();
+
+	Util::ThrowExceptionIf(!groupExists, "Read group '%d' does not exist.", groupId);
+	Util::ThrowExceptionIf(groupExists && mustBeValid && !groupValid, "Read group '%d' is invalid, a device was removed by a sync.", groupId);
+
+	return groupExists && (groupValid || !mustBeValid);
+}
+
+
 int Read::GetFieldBitMask(const Arguments& args){
 
 	int mask=0; std::string field;
@@ -50,3 +334,35 @@ int Read::GetFieldBitMask(const Arguments& args){
 }
 
 
+//The planned read order with its cost, the cost of the request order
+//is added for comparison
+Handle<Object> Read::PlanToV8Object(Controller* ctl, std::vector<std::string>* deviceIds){
+
+	ReadPlanner planner;
+	std::vector<Device*> requested = FindDevices(ctl, deviceIds, false);
+	std::vector<Device*> planned   = FindDevices(ctl, deviceIds, true);
+	ReadCost cost = planner.EstimateCost(&planned);
+
+	Handle<Object> result = Object::New();
+	Handle<Array> plannedIds = Array::New();
+
+	for (unsigned int i=0; i < planned.size(); i++)
+		plannedIds->Set(i, String::New(planned[i]->GetStrId()->c_str()));
+
+	AddPairToV8Object(result, "deviceIds", plannedIds);
+	AddPairToV8Object(result, "channelSelects", cost.channelSelects);
+	AddPairToV8Object(result, "speedChanges", cost.speedChanges);
+	AddPairToV8Object(result, "requestOrder", CostToV8Object(planner.EstimateCost(&requested)));
+
+	return result;
+}
+
+
+Handle<Object> Read::CostToV8Object(ReadCost cost){
+
+	Handle<Object> result = Object::New();
+	AddPairToV8Object(result, "channelSelects", cost.channelSelects);
+	AddPairToV8Object(result, "speedChanges", cost.speedChanges);
+
+	return result;
+}
@@ -2,7 +2,9 @@
 #define READ_H
 
 #include "api.h"
+#include "../controller/read_planner.h"
 #include <node.h>
+#include <vector>
 
 using namespace v8;
 
@@ -11,10 +13,31 @@ class Read: public Api   {
 
 public:
   static Handle<Value> DevicesById(const Arguments&);
+  static Handle<Value> DevicesByIdAsync(const Arguments&);
+  static Handle<Value> PlanDevicesById(const Arguments&);
+  static Handle<Value> PlanDevicesByIdAsync(const Arguments&);
+  static Handle<Value> PrepareGroup(const Arguments&);
+  static Handle<Value> PrepareGroupAsync(const Arguments&);
+  static Handle<Value> Group(const Arguments&);
+  static Handle<Value> GroupAsync(const Arguments&);
+  static Handle<Value> ReleaseGroup(const Arguments&);
+  static Handle<Value> ReleaseGroupAsync(const Arguments&);
 
 
 private:
+  static bool DevicesByIdAssertParams(const Arguments&);
+  static bool PlanDevicesByIdAssertParams(const Arguments&);
+  static bool GroupAssertParams(const Arguments&);
+  static bool AssertReadGroup(const Arguments&, bool);
   static int GetFieldBitMask(const Arguments&);
+  static Handle<Object> PlanToV8Object(Controller*, std::vector<std::string>*);
+  static Handle<Object> CostToV8Object(ReadCost);
+
+  friend class DevicesByIdJob;
+  friend class PlanDevicesByIdJob;
+  friend class PrepareGroupJob;
+  friend class GroupJob;
+  friend class ReleaseGroupJob;
 
 
 };
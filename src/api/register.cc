@@ -1,7 +1,14 @@
 #include "register.h"
+#include "async.h"
 #include "../manager.h"
 #include "../master/ds2482.h"
+#include "../master/transport/smbus_transport.h"
+#include "../master/transport/i2c_transport.h"
+#include "../master/transport/ds2482_emulator.h"
+#include "../master/sim/simulated_master.h"
 #include "../controller/controller.h"
+#include "../shared/util.h"
+#include "../shared/match.h"
 #include <string>
 #include <stdio.h>
 
@@ -12,18 +19,143 @@ using namespace v8;
 #define CP_ADDRESS  "address"
 #define CP_SUBTYPE  "subType"
 #define CV_SUBTYPE  "100|800"
+#define CP_TRANSPORT "transport"
+#define CV_TRANSPORT "smbus|i2c"
+#define CP_BUSES	"buses"
+#define CP_RESET_LATENCY	"resetLatency"
+#define CP_BYTE_LATENCY		"byteLatency"
+#define CP_TRIPLET_LATENCY	"tripletLatency"
+#define CP_SELECT_LATENCY	"selectLatency"
+#define CP_EMULATE_TIMING	"emulateTiming"
+
+
+class DS2482MasterJob : public AsyncJob {
+
+  public:
+	DS2482MasterJob(DS2482* master, std::string devFile, int address)
+		: master(master), devFile(devFile), address(address) {}
+
+
+	~DS2482MasterJob(void){
+		if (HasError()) delete master;
+	}
+
+
+	void Execute(void){
+		bool success = master->Initialize(&devFile, address);
+		SetErrorIf(!success, "%s", master->GetError());
+	}
+
+
+	//masters are only added on the loop thread
+	Handle<Value> BuildResult(void){
+		controller->AddMaster(master->GetName(), master);
+		return Undefined();
+	}
+
+
+  private:
+	DS2482* master;
+	std::string devFile;
+	int address;
+};
+
+
+
+class SimulatedMasterJob : public AsyncJob {
+
+  public:
+	SimulatedMasterJob(::SimulatedMaster* master) : master(master) {}
+
+
+	//nothing to initialize
+	void Execute(void){}
+
+
+	Handle<Value> BuildResult(void){
+		controller->AddMaster(master->GetName(), master);
+		return Undefined();
+	}
+
+
+  private:
+	::SimulatedMaster* master;
+};
+
 
 
 Handle<Value> Register::DS2482Master(const Arguments& args) {
 	HandleScope scope;
 
-	if (DS2482MasterAssertParams(args))
+	if (AssertIdle(args) && DS2482MasterAssertParams(args))
 	    DS2482MasterSetup(args);
 
 	return scope.Close(Undefined());
 }
 
 
+Handle<Value> Register::DS2482MasterAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (DS2482MasterAssertParams(args) && AssertCallback(args)){
+		std::string masterName = GetStrParam(args, CP_NAME);
+		std::string subType    = GetStrParam(args, CP_SUBTYPE);
+		DS2482 *ds2482Master   = new DS2482(&masterName, &subType, NewTransport(args));
+
+		Async::Queue(args, new DS2482MasterJob(ds2482Master, GetStrParam(args, CP_DEV_FILE), GetIntParam(args, CP_ADDRESS)));
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Register::EmulatedDS2482Master(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && EmulatedDS2482MasterAssertParams(args)){
+		std::string devFile  = "emulator";
+		DS2482* ds2482Master = NewEmulatedDS2482(args);
+
+		ds2482Master->Initialize(&devFile, 0);
+		GetController(args)->AddMaster(ds2482Master->GetName(), ds2482Master);
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Register::EmulatedDS2482MasterAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (EmulatedDS2482MasterAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new DS2482MasterJob(NewEmulatedDS2482(args), "emulator", 0));
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Register::SimulatedMaster(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && SimulatedMasterAssertParams(args)){
+		::SimulatedMaster* master = NewSimulatedMaster(args);
+		GetController(args)->AddMaster(master->GetName(), master);
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Register::SimulatedMasterAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (SimulatedMasterAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new SimulatedMasterJob(NewSimulatedMaster(args)));
+
+	return scope.Close(Undefined());
+}
+
+
 //private
 
 bool Register::DS2482MasterAssertParams(const Arguments& args){
@@ -34,25 +166,149 @@ bool Register::DS2482MasterAssertParams(const Arguments& args){
     AssertParam(args, CP_SUBTYPE,   DT_STRING)  &&
     AssertParam(args, CP_DEV_FILE,  DT_STRING)  &&
     AssertParam(args, CP_ADDRESS,   DT_NUMBER)  &&
-    AssertParamIn(args, CP_SUBTYPE, CV_SUBTYPE);
+    AssertParamIn(args, CP_SUBTYPE, CV_SUBTYPE) &&
+    AssertOptionalParam(args, CP_TRANSPORT, DT_STRING) &&
+    (!V8ObjectHasKey(args[0], CP_TRANSPORT) || AssertParamIn(args, CP_TRANSPORT, CV_TRANSPORT));
 
 }
 
 
+//SMBus is the default, "i2c" combines write and read into one transfer
+Transport* Register::NewTransport(const Arguments& args){
+
+	if (V8ObjectHasKey(args[0], CP_TRANSPORT) && GetStrParam(args, CP_TRANSPORT).compare("i2c") == 0)
+		return new I2cTransport();
+
+	return new SmbusTransport();
+}
+
+
 void Register::DS2482MasterSetup(const Arguments& args){
 	std::string masterName = GetStrParam(args, CP_NAME);
     std::string devFile    = GetStrParam(args, CP_DEV_FILE);
 	std::string subType    = GetStrParam(args, CP_SUBTYPE);
     int devTargetAddress   = GetIntParam(args, CP_ADDRESS);
-    DS2482 *ds2482Master   = new DS2482(&masterName, &devFile);
+    DS2482 *ds2482Master   = new DS2482(&masterName, &subType, NewTransport(args));
 
 
 	if (ds2482Master->Initialize(&devFile, devTargetAddress)){
 	    Manager* manager = node::ObjectWrap::Unwrap<Manager>(args.This());
 		manager->controller->AddMaster(ds2482Master->GetName(), ds2482Master);
+
+	} else
+		Util::ThrowExceptionIf(true, "%s", ds2482Master->GetError());
+
+}
+
+
+
+bool Register::SimulatedMasterAssertParams(const Arguments& args){
+
+  return
+	AssertParamsFormat(args) 								&&
+	AssertParam(args, CP_NAME,  DT_STRING)  				&&
+	AssertParam(args, CP_BUSES, DT_ARRAY)  					&&
+	AssertOptionalParam(args, CP_RESET_LATENCY,   DT_NUMBER) &&
+	AssertOptionalParam(args, CP_BYTE_LATENCY,    DT_NUMBER) &&
+	AssertOptionalParam(args, CP_TRIPLET_LATENCY, DT_NUMBER) &&
+	AssertOptionalParam(args, CP_SELECT_LATENCY,  DT_NUMBER) &&
+	AssertBusesParam(args);
+
+}
+
+
+//One array of device ids per bus
+bool Register::AssertBusesParam(const Arguments& args){
+
+	Handle<Array> buses = GetV8ArrayParam(args, CP_BUSES);
+	bool valid = buses->Length() > 0;
+	Util::ThrowExceptionIf(!valid, "Param '%s' must contain at least one bus", CP_BUSES);
+
+	for (unsigned int i=0; valid && i < buses->Length(); ++i){
+		Handle<Array> deviceIds = Handle<Array>::Cast(buses->Get(i));
+		valid = V8ValueIsFromDataType(deviceIds, DT_ARRAY);
+		Util::ThrowExceptionIf(!valid, "Data type for param '%s' must be '%s' of '%s'", CP_BUSES, DT_ARRAY, DT_ARRAY);
+
+		for (unsigned int j=0; valid && j < deviceIds->Length(); ++j){
+			std::string deviceId = V8ValueToStdString(deviceIds->Get(j));
+			valid = Match::PatternOrList(MP_DEVICE_ID, deviceId.c_str());
+			Util::ThrowExceptionIf(!valid, "Value '%s' invalid for array '%s'. Allowed values: %s", deviceId.c_str(), CP_BUSES, MP_DEVICE_ID);
+		}
 	}
 
+	return valid;
+}
+
+
+::SimulatedMaster* Register::NewSimulatedMaster(const Arguments& args){
+
+	std::string masterName = GetStrParam(args, CP_NAME);
+	Handle<Array> buses    = GetV8ArrayParam(args, CP_BUSES);
+	::SimulatedMaster* master = new ::SimulatedMaster(&masterName, buses->Length());
+
+	AddVirtualDevices(args, master->GetWires());
+
+	SetLatencyIf(args, master, CP_RESET_LATENCY,   LAT_RESET);
+	SetLatencyIf(args, master, CP_BYTE_LATENCY,    LAT_BYTE);
+	SetLatencyIf(args, master, CP_TRIPLET_LATENCY, LAT_TRIPLET);
+	SetLatencyIf(args, master, CP_SELECT_LATENCY,  LAT_SELECT);
+
+	return master;
 }
 
 
+void Register::SetLatencyIf(const Arguments& args, ::SimulatedMaster* master, const char* key, int command){
+	if (V8ObjectHasKey(args[0], key))
+		master->SetLatency(command, GetIntParam(args, key));
+}
+
+
+bool Register::EmulatedDS2482MasterAssertParams(const Arguments& args){
+
+  bool valid =
+	AssertParamsFormat(args) 								&&
+	AssertParam(args, CP_NAME, 	  DT_STRING)  				&&
+	AssertParam(args, CP_SUBTYPE, DT_STRING)  				&&
+	AssertParam(args, CP_BUSES,   DT_ARRAY)  				&&
+	AssertOptionalParam(args, CP_EMULATE_TIMING, DT_BOOLEAN) &&
+	AssertParamIn(args, CP_SUBTYPE, CV_SUBTYPE)				&&
+	AssertBusesParam(args);
+
+  if (valid){
+	  unsigned int busCount = GetStrParam(args, CP_SUBTYPE).compare("100") == 0 ? 1 : 8;
+	  valid = GetV8ArrayParam(args, CP_BUSES)->Length() <= busCount;
+	  Util::ThrowExceptionIf(!valid, "Param '%s' must not contain more than %u buses", CP_BUSES, busCount);
+  }
+
+  return valid;
+}
+
 
+//Timing is emulated, unless disabled
+DS2482* Register::NewEmulatedDS2482(const Arguments& args){
+
+	std::string masterName = GetStrParam(args, CP_NAME);
+	std::string subType    = GetStrParam(args, CP_SUBTYPE);
+	bool timing = !V8ObjectHasKey(args[0], CP_EMULATE_TIMING) || GetOptionalBoolParam(args, CP_EMULATE_TIMING);
+
+	Ds2482Emulator* emulator = new Ds2482Emulator(subType.compare("100") == 0 ? 1 : 8, timing);
+	AddVirtualDevices(args, emulator->GetWires());
+
+	return new DS2482(&masterName, &subType, emulator);
+}
+
+
+void Register::AddVirtualDevices(const Arguments& args, std::vector<VirtualWire*>* wires){
+
+	Handle<Array> buses = GetV8ArrayParam(args, CP_BUSES);
+
+	for (unsigned int i=0; i < buses->Length(); ++i){
+		Handle<Array> deviceIds = Handle<Array>::Cast(buses->Get(i));
+
+		for (unsigned int j=0; j < deviceIds->Length(); ++j){
+			std::string deviceId = V8ValueToStdString(deviceIds->Get(j));
+			wires->at(i)->AddDevice(VirtualDevice::New(Util::HexStrToUInt64(&deviceId)));
+		}
+	}
+
+}
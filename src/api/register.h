@@ -2,6 +2,10 @@
 #define REGISTER_H
 
 #include "api.h"
+#include "../master/transport/transport.h"
+#include "../master/sim/simulated_master.h"
+#include "../master/ds2482.h"
+#include <vector>
 #include <node.h>
 
 using namespace v8;
@@ -11,11 +15,26 @@ class Register : public Api   {
 
 public:
   static Handle<Value> DS2482Master(const Arguments&);
+  static Handle<Value> DS2482MasterAsync(const Arguments&);
+  static Handle<Value> EmulatedDS2482Master(const Arguments&);
+  static Handle<Value> EmulatedDS2482MasterAsync(const Arguments&);
+  static Handle<Value> SimulatedMaster(const Arguments&);
+  static Handle<Value> SimulatedMasterAsync(const Arguments&);
 
 
 private:
   static bool DS2482MasterAssertParams(const Arguments&);
   static void DS2482MasterSetup(const Arguments&);
+  static Transport* NewTransport(const Arguments&);
+
+  static bool SimulatedMasterAssertParams(const Arguments&);
+  static bool AssertBusesParam(const Arguments&);
+  static ::SimulatedMaster* NewSimulatedMaster(const Arguments&);
+  static void SetLatencyIf(const Arguments&, ::SimulatedMaster*, const char*, int);
+
+  static bool EmulatedDS2482MasterAssertParams(const Arguments&);
+  static DS2482* NewEmulatedDS2482(const Arguments&);
+  static void AddVirtualDevices(const Arguments&, std::vector<VirtualWire*>*);
 
 };
 
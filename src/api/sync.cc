@@ -1,19 +1,69 @@
 #include "sync.h"
+#include "async.h"
 #include "../controller/controller.h"
+#include "../shared/util.h"
 #include <node.h>
 
+#define CP_PARALLEL "parallel"
+#define CP_DETECT_OVERDRIVE "detectOverdrive"
+#define CP_MAX_DEVICES "maxDevices"
+
 using namespace v8;
 
 
+class SyncJob : public AsyncJob {
+
+  public:
+	SyncJob(Master* master, Bus* bus, bool parallel, bool detectOverdrive, int maxDevices)
+		: master(master), bus(bus), parallel(parallel), detectOverdrive(detectOverdrive), maxDevices(maxDevices), finished(true) {}
+
+
+	void Execute(void){
+		controller->GetDeviceStore()->ResetAllChanges(true);
+
+		if (bus != NULL)
+			finished = controller->SyncBusDevices(bus, detectOverdrive, maxDevices);
+		else if (master != NULL)
+			controller->SyncMasterDevices(master, detectOverdrive);
+		else
+			controller->SyncAllDevices(parallel, detectOverdrive);
+	}
+
+
+	Handle<Value> BuildResult(void){
+		Handle<Object> result = Sync::ResponseSummary(controller->GetDeviceStore());
+
+		if (maxDevices > 0)
+			result->Set(String::New("finished"), Boolean::New(finished));
+
+		return result;
+	}
+
+
+  private:
+	Master* master;
+	Bus* bus;
+	bool parallel;
+	bool detectOverdrive;
+	int  maxDevices;
+	bool finished;
+};
+
+
+
 Handle<Value> Sync::AllDevices(const Arguments& args) {
   HandleScope scope;
 
   Controller* ctl = GetController(args);
   DeviceStore* ds = ctl->GetDeviceStore();
-  ds->ResetAllChanges(true);
-  ctl->SyncAllDevices();
 
-  return scope.Close(ResponseSummary(ds));
+  if (AssertIdle(args) && AllDevicesAssertParams(args)){
+	  ds->ResetAllChanges(true);
+	  ctl->SyncAllDevices(GetOptionalBoolParam(args, CP_PARALLEL), GetOptionalBoolParam(args, CP_DETECT_OVERDRIVE));
+	  return scope.Close(ResponseSummary(ds));
+  }
+
+  return scope.Close(Undefined());
 }
 
 
@@ -24,14 +74,9 @@ Handle<Value> Sync::MasterDevices(const Arguments& args) {
   Controller* ctl = GetController(args);
   DeviceStore* ds = ctl->GetDeviceStore();
 
-  bool validArgs =
-	AssertParamsFormat(args) &&
-	AssertDefaultParam(args, DP_MASTER_NAME) &&
-	AssertMaster(args);
-
-  if (validArgs){
+  if (AssertIdle(args) && MasterDevicesAssertParams(args)){
 	  ds->ResetAllChanges(true);
- 	  ctl->SyncMasterDevices(GetMaster(args));
+ 	  ctl->SyncMasterDevices(GetMaster(args), GetOptionalBoolParam(args, CP_DETECT_OVERDRIVE));
  	  return scope.Close(ResponseSummary(ds));
   }
 
@@ -46,25 +91,104 @@ Handle<Value> Sync::BusDevices(const Arguments& args) {
   Controller* ctl = GetController(args);
   DeviceStore* ds = ctl->GetDeviceStore();
 
-  bool validArgs =
+  if (AssertIdle(args) && BusDevicesAssertParams(args)){
+	  int maxDevices = GetMaxDevicesParam(args);
+	  ds->ResetAllChanges(true);
+	  bool finished = ctl->SyncBusDevices(GetBus(args), GetOptionalBoolParam(args, CP_DETECT_OVERDRIVE), maxDevices);
+
+	  Handle<Object> result = ResponseSummary(ds);
+	  if (maxDevices > 0)
+		  result->Set(String::New("finished"), Boolean::New(finished));
+
+	  return scope.Close(result);
+  }
+
+  return scope.Close(Undefined());
+}
+
+
+
+Handle<Value> Sync::AllDevicesAsync(const Arguments& args) {
+  HandleScope scope;
+
+  if (AllDevicesAssertParams(args) && AssertCallback(args))
+	  Async::Queue(args, new SyncJob(NULL, NULL, GetOptionalBoolParam(args, CP_PARALLEL), GetOptionalBoolParam(args, CP_DETECT_OVERDRIVE), 0));
+
+  return scope.Close(Undefined());
+}
+
+
+
+Handle<Value> Sync::MasterDevicesAsync(const Arguments& args) {
+  HandleScope scope;
+
+  if (MasterDevicesAssertParams(args) && AssertCallback(args))
+	  Async::Queue(args, new SyncJob(GetMaster(args), NULL, false, GetOptionalBoolParam(args, CP_DETECT_OVERDRIVE), 0));
+
+  return scope.Close(Undefined());
+}
+
+
+
+Handle<Value> Sync::BusDevicesAsync(const Arguments& args) {
+  HandleScope scope;
+
+  if (BusDevicesAssertParams(args) && AssertCallback(args))
+	  Async::Queue(args, new SyncJob(GetMaster(args), GetBus(args), false, GetOptionalBoolParam(args, CP_DETECT_OVERDRIVE), GetMaxDevicesParam(args)));
+
+  return scope.Close(Undefined());
+}
+
+
+
+//private
+
+bool Sync::AllDevicesAssertParams(const Arguments& args){
+  return
+	AssertOptionalParam(args, CP_PARALLEL, DT_BOOLEAN) &&
+	AssertOptionalParam(args, CP_DETECT_OVERDRIVE, DT_BOOLEAN);
+}
+
+
+bool Sync::MasterDevicesAssertParams(const Arguments& args){
+
+  return
+	AssertParamsFormat(args) &&
+	AssertDefaultParam(args, DP_MASTER_NAME) &&
+	AssertOptionalParam(args, CP_DETECT_OVERDRIVE, DT_BOOLEAN) &&
+	AssertMaster(args);
+
+}
+
+
+bool Sync::BusDevicesAssertParams(const Arguments& args){
+
+  return
 	AssertParamsFormat(args) &&
     AssertDefaultParam(args, DP_MASTER_NAME) &&
     AssertDefaultParam(args, DP_BUS_NUMBER)  &&
+	AssertOptionalParam(args, CP_DETECT_OVERDRIVE, DT_BOOLEAN) &&
+	AssertOptionalParam(args, CP_MAX_DEVICES, DT_NUMBER) &&
+	AssertMaxDevicesParam(args) &&
 	AssertMaster(args) &&
 	AssertBus(args);
 
-  if (validArgs){
-	  ds->ResetAllChanges(true);
-	  ctl->SyncBusDevices(GetBus(args));
-	  return scope.Close(ResponseSummary(ds));
-  }
+}
 
-  return scope.Close(Undefined());
+
+bool Sync::AssertMaxDevicesParam(const Arguments& args){
+	bool valid = GetMaxDevicesParam(args) >= 0;
+	Util::ThrowExceptionIf(!valid, "Param '%s' must not be negative", CP_MAX_DEVICES);
+
+	return valid;
 }
 
 
+//0 searches the whole bus
+int Sync::GetMaxDevicesParam(const Arguments& args){
+	return V8ObjectHasKey(args[0], CP_MAX_DEVICES) ? GetIntParam(args, CP_MAX_DEVICES) : 0;
+}
 
-//private
 
 Handle<Object> Sync::ResponseSummary(DeviceStore* ds){
 
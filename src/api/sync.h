@@ -15,12 +15,23 @@ public:
   static Handle<Value> MasterDevices(const Arguments&);
   static Handle<Value> BusDevices(const Arguments&);
 
+  static Handle<Value> AllDevicesAsync(const Arguments&);
+  static Handle<Value> MasterDevicesAsync(const Arguments&);
+  static Handle<Value> BusDevicesAsync(const Arguments&);
+
 
 private:
+  static bool AllDevicesAssertParams(const Arguments&);
+  static bool MasterDevicesAssertParams(const Arguments&);
+  static bool BusDevicesAssertParams(const Arguments&);
+  static bool AssertMaxDevicesParam(const Arguments&);
+  static int  GetMaxDevicesParam(const Arguments&);
   static Handle<Object> ResponseSummary(DeviceStore* ds);
   static std::string MasterName(Handle<Value>);
   static int BusNumber(Handle<Value>);
 
+  friend class SyncJob;
+
 };
 
 
@@ -0,0 +1,219 @@
+#include "temperature.h"
+#include "async.h"
+#include "../controller/temperature_engine.h"
+#include "../master/master.h"
+#include "../device/lib/temp.h"
+#include <node.h>
+#include <vector>
+#include <map>
+#include <string>
+#include <stdio.h>
+
+using namespace v8;
+
+#define CP_RESOLUTIONS  "resolutions"
+#define CV_RESOLUTIONS  "9bit|10bit|11bit|12bit"
+
+
+class ConvertAndReadJob : public AsyncJob {
+
+  public:
+	ConvertAndReadJob(std::vector<Bus*> buses, std::vector<int> resolutions)
+		: buses(buses), resolutions(resolutions), engine(NULL) {}
+
+
+	~ConvertAndReadJob(void){
+		delete engine;
+	}
+
+
+	void Execute(void){
+		engine = new TemperatureEngine(controller->GetDeviceStore());
+		engine->SetResolutions(&resolutions);
+		engine->ConvertAndRead(&buses);
+	}
+
+
+	Handle<Value> BuildResult(void){
+		return Temperature::DevicesToV8Object(engine->GetDevices(), DDT_VALUES, engine->GetVerified());
+	}
+
+
+  private:
+	std::vector<Bus*> buses;
+	std::vector<int> resolutions;
+	TemperatureEngine* engine;
+};
+
+
+
+class GroupsJob : public AsyncJob {
+
+  public:
+	GroupsJob(std::vector<Bus*> buses) : buses(buses) {}
+
+
+	void Execute(void){
+		TemperatureEngine engine(controller->GetDeviceStore());
+		groups = engine.GetGroups(&buses);
+	}
+
+
+	Handle<Value> BuildResult(void){
+		return Temperature::GroupsToV8Object(&groups);
+	}
+
+
+  private:
+	std::vector<Bus*> buses;
+	std::map<int, TemperatureGroup> groups;
+};
+
+
+
+Handle<Value> Temperature::ConvertAndRead(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && ConvertAndReadAssertParams(args)){
+		std::vector<Bus*> buses = GetSelectedBuses(args);
+		std::vector<int> resolutions = GetResolutions(args);
+		TemperatureEngine engine(GetController(args)->GetDeviceStore());
+
+		engine.SetResolutions(&resolutions);
+		engine.ConvertAndRead(&buses);
+		return scope.Close(DevicesToV8Object(engine.GetDevices(), DDT_VALUES, engine.GetVerified()));
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Temperature::ConvertAndReadAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (ConvertAndReadAssertParams(args) && AssertCallback(args))
+		Async::Queue(args, new ConvertAndReadJob(GetSelectedBuses(args), GetResolutions(args)));
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Temperature::Groups(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && AssertSelection(args)){
+		std::vector<Bus*> buses = GetSelectedBuses(args);
+		TemperatureEngine engine(GetController(args)->GetDeviceStore());
+		std::map<int, TemperatureGroup> groups = engine.GetGroups(&buses);
+
+		return scope.Close(GroupsToV8Object(&groups));
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Temperature::GroupsAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertSelection(args) && AssertCallback(args))
+		Async::Queue(args, new GroupsJob(GetSelectedBuses(args)));
+
+	return scope.Close(Undefined());
+}
+
+
+//private
+
+bool Temperature::ConvertAndReadAssertParams(const Arguments& args){
+
+	return
+		AssertSelection(args) &&
+		(!HasParam(args, CP_RESOLUTIONS) || AssertParam(args, CP_RESOLUTIONS, DT_ARRAY)) &&
+		(!HasParam(args, CP_RESOLUTIONS) || AssertArrayParamIn(args, CP_RESOLUTIONS, CV_RESOLUTIONS));
+
+}
+
+
+//All buses by default, limited to one master and one of its buses
+bool Temperature::AssertSelection(const Arguments& args){
+
+	bool hasMaster = HasParam(args, DP_MASTER_NAME);
+	bool hasBus    = HasParam(args, DP_BUS_NUMBER);
+
+	return
+		AssertOptionalParam(args, DP_MASTER_NAME, DT_STRING) &&
+		AssertOptionalParam(args, DP_BUS_NUMBER,  DT_NUMBER) &&
+		(!hasBus 	|| AssertDefaultParam(args, DP_MASTER_NAME)) &&
+		(!hasMaster || AssertMaster(args)) &&
+		(!hasBus 	|| AssertBus(args));
+
+}
+
+
+std::vector<Bus*> Temperature::GetSelectedBuses(const Arguments& args){
+
+	std::vector<Bus*> buses;
+	std::map<std::string, Master*>::iterator itM;
+
+	if (HasParam(args, DP_BUS_NUMBER))
+		buses.push_back(GetBus(args));
+
+	else if (HasParam(args, DP_MASTER_NAME))
+		buses = *GetMaster(args)->GetBuses();
+
+	else {
+		Controller* controller = GetController(args);
+
+		for (itM = controller->masters.begin(); itM != controller->masters.end(); ++itM)
+			buses.insert(buses.end(), itM->second->GetBuses()->begin(), itM->second->GetBuses()->end());
+	}
+
+	return buses;
+}
+
+
+//All resolutions if not given
+std::vector<int> Temperature::GetResolutions(const Arguments& args){
+
+	std::vector<int> resolutions;
+	std::vector<std::string> names;
+
+	if (HasParam(args, CP_RESOLUTIONS))
+		names = GetStrArrayParam(args, CP_RESOLUTIONS);
+
+	for (unsigned int i=0; i < names.size(); i++)
+		resolutions.push_back(Temp::ResolutionFromString(names[i].c_str()));
+
+	return resolutions;
+}
+
+
+bool Temperature::HasParam(const Arguments& args, const char* key){
+	return HasParamsObject(args) && V8ObjectHasKey(args[0], key);
+}
+
+
+//Keyed by resolution, e.g. '9bit'
+Handle<Object> Temperature::GroupsToV8Object(std::map<int, TemperatureGroup>* groups){
+
+	Handle<Object> result = Object::New();
+	std::map<int, TemperatureGroup>::iterator it;
+	char key[8];
+
+	for (it = groups->begin(); it != groups->end(); ++it){
+		Handle<Object> group = Object::New();
+		Handle<Array> deviceIds = Array::New();
+
+		for (unsigned int i=0; i < it->second.devices.size(); i++)
+			deviceIds->Set(i, String::New(it->second.devices[i]->GetStrId()->c_str()));
+
+		AddPairToV8Object(group, "conversionTime", it->second.conversionTime);
+		AddPairToV8Object(group, "deviceIds", deviceIds);
+
+		snprintf(key, sizeof(key), "%dbit", it->first);
+		AddPairToV8Object(result, key, group);
+	}
+
+	return result;
+}
@@ -0,0 +1,36 @@
+#ifndef TEMPERATURE_H
+#define TEMPERATURE_H
+
+#include "api.h"
+#include "../controller/temperature_engine.h"
+#include <node.h>
+#include <vector>
+#include <map>
+
+using namespace v8;
+
+
+class Temperature: public Api   {
+
+public:
+  static Handle<Value> ConvertAndRead(const Arguments&);
+  static Handle<Value> ConvertAndReadAsync(const Arguments&);
+  static Handle<Value> Groups(const Arguments&);
+  static Handle<Value> GroupsAsync(const Arguments&);
+
+
+private:
+  static bool ConvertAndReadAssertParams(const Arguments&);
+  static bool AssertSelection(const Arguments&);
+  static std::vector<Bus*> GetSelectedBuses(const Arguments&);
+  static std::vector<int> GetResolutions(const Arguments&);
+  static bool HasParam(const Arguments&, const char*);
+  static Handle<Object> GroupsToV8Object(std::map<int, TemperatureGroup>*);
+
+  friend class ConvertAndReadJob;
+  friend class GroupsJob;
+
+};
+
+
+#endif
@@ -1,5 +1,8 @@
 #include "update.h"
+#include "async.h"
 #include "../shared/util.h"
+#include "../shared/match.h"
+#include "../master/master.h"
 #include <vector>
 #include <algorithm>
 
@@ -7,16 +10,85 @@ using namespace v8;
 
 #define CP_SET 	  "set"
 #define CP_VALUE  "value"
+#define CP_ACTIVE_PULLUP "activePullup"
+#define CP_STRONG_PULLUP "strongPullup"
+
+//Pullup params which are not given stay unchanged
+#define PULLUP_UNCHANGED -1
+
+
+class DeviceByIdJob : public AsyncJob {
+
+  public:
+	DeviceByIdJob(std::string deviceId, std::string name, std::string value)
+		: deviceId(deviceId), name(name), value(value), succeed(false) {}
+
+
+	void Execute(void){
+
+		if (!AssertDevice(&deviceId))
+			return;
+
+		Device* device = controller->GetDeviceStore()->GetDevice(Util::HexStrToUInt64(&deviceId));
+		bool supported = device->SupportsUpdater(&name);
+		SetErrorIf(!supported, "Update of '%s' is not supported on device %s", name.c_str(), device->GetStrId()->c_str());
+
+		const char* validator = supported ? device->GetUpdaterValidator(&name) : "";
+		bool valid = supported && Match::PatternOrList(validator, value.c_str());
+		SetErrorIf(supported && !valid, "Value '%s' invalid for param '%s'. Allowed values: %s", value.c_str(), CP_VALUE, validator);
+
+		if (valid)
+			succeed = device->ExecuteUpdater(&name, &value);
+	}
+
+
+	Handle<Value> BuildResult(void){
+		Handle<Object> result = Object::New();
+		Update::AddPairToV8Object(result, "crcError", !succeed);
+		return result;
+	}
+
+
+  private:
+	std::string deviceId;
+	std::string name;
+	std::string value;
+	bool succeed;
+};
+
+
+
+class BusConfigJob : public AsyncJob {
+
+  public:
+	BusConfigJob(Bus* bus, int activePullup, int strongPullup)
+		: bus(bus), activePullup(activePullup), strongPullup(strongPullup) {}
+
+
+	void Execute(void){
+		Update::ExecuteBusConfig(bus, activePullup, strongPullup);
+	}
+
+
+	Handle<Value> BuildResult(void){
+		return Update::BusConfigToV8Object(bus);
+	}
+
+
+  private:
+	Bus* bus;
+	int activePullup;
+	int strongPullup;
+};
+
 
 
 Handle<Value> Update::DeviceById(const Arguments& args) {
 	HandleScope scope;
 
 	bool validArgs =
-	  AssertParamsFormat(args) 				 &&
-  	  AssertDefaultParam(args, DP_DEVICE_ID) &&
-  	  AssertParam(args, CP_SET,   DT_STRING) &&
-  	  AssertParam(args, CP_VALUE, DT_STRING) &&
+	  AssertIdle(args)						 &&
+	  DeviceByIdAssertParams(args)			 &&
   	  AssertDevice(args)					 &&
   	  AssertUpdaterExists(args)				 &&
   	  AssertUpdaterValue(args);
@@ -32,9 +104,59 @@ Handle<Value> Update::DeviceById(const Arguments& args) {
 }
 
 
+Handle<Value> Update::DeviceByIdAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (DeviceByIdAssertParams(args) && AssertCallback(args)){
+		std::string deviceId = GetStrParam(args, DP_DEVICE_ID);
+		Async::Queue(args, new DeviceByIdJob(deviceId, GetUpdaterName(args), GetStrParam(args, CP_VALUE)));
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+
+Handle<Value> Update::BusConfig(const Arguments& args) {
+	HandleScope scope;
+
+	if (AssertIdle(args) && BusConfigAssertParams(args)){
+		Bus* bus = GetBus(args);
+		ExecuteBusConfig(bus, GetPullupParam(args, CP_ACTIVE_PULLUP), GetPullupParam(args, CP_STRONG_PULLUP));
+		return scope.Close(BusConfigToV8Object(bus));
+	}
+
+	return scope.Close(Undefined());
+}
+
+
+Handle<Value> Update::BusConfigAsync(const Arguments& args) {
+	HandleScope scope;
+
+	if (BusConfigAssertParams(args) && AssertCallback(args)){
+		int activePullup = GetPullupParam(args, CP_ACTIVE_PULLUP);
+		int strongPullup = GetPullupParam(args, CP_STRONG_PULLUP);
+		Async::Queue(args, new BusConfigJob(GetBus(args), activePullup, strongPullup));
+	}
+
+	return scope.Close(Undefined());
+}
+
+
 
 // private
 
+bool Update::DeviceByIdAssertParams(const Arguments& args){
+
+	return
+	  AssertParamsFormat(args) 				 &&
+  	  AssertDefaultParam(args, DP_DEVICE_ID) &&
+  	  AssertParam(args, CP_SET,   DT_STRING) &&
+  	  AssertParam(args, CP_VALUE, DT_STRING);
+
+}
+
+
 bool Update::AssertUpdaterExists(const Arguments& args){
 	Device* device = GetDevice(args);
 	std::string name = GetUpdaterName(args);
@@ -62,3 +184,45 @@ bool Update::ExecuteUpdater(const Arguments& args){
 
 	return GetDevice(args)->ExecuteUpdater(&name, &value);
 }
+
+
+bool Update::BusConfigAssertParams(const Arguments& args){
+
+	return
+	  AssertParamsFormat(args) 				   			  &&
+	  AssertDefaultParam(args, DP_MASTER_NAME) 			  &&
+	  AssertDefaultParam(args, DP_BUS_NUMBER)  			  &&
+	  AssertOptionalParam(args, CP_ACTIVE_PULLUP, DT_BOOLEAN) &&
+	  AssertOptionalParam(args, CP_STRONG_PULLUP, DT_BOOLEAN) &&
+	  AssertMaster(args)					   			  &&
+	  AssertBus(args);
+
+}
+
+
+int Update::GetPullupParam(const Arguments& args, const char* key){
+
+	if (!V8ObjectHasKey(args[0], key))
+		return PULLUP_UNCHANGED;
+
+	return GetOptionalBoolParam(args, key) ? 1 : 0;
+}
+
+
+//The active pullup is written to the master, if the bus is selected
+void Update::ExecuteBusConfig(Bus* bus, int activePullup, int strongPullup){
+
+	if (activePullup != PULLUP_UNCHANGED)
+		bus->SetActivePullup(activePullup == 1);
+
+	if (strongPullup != PULLUP_UNCHANGED)
+		bus->SetStrongPullup(strongPullup == 1);
+}
+
+
+Handle<Object> Update::BusConfigToV8Object(Bus* bus){
+	Handle<Object> result = Object::New();
+	AddPairToV8Object(result, CP_ACTIVE_PULLUP, bus->HasActivePullup());
+	AddPairToV8Object(result, CP_STRONG_PULLUP, bus->HasStrongPullup());
+	return result;
+}
@@ -11,14 +11,26 @@ class Update: public Api   {
 
 public:
   static Handle<Value> DeviceById(const Arguments&);
+  static Handle<Value> DeviceByIdAsync(const Arguments&);
+  static Handle<Value> BusConfig(const Arguments&);
+  static Handle<Value> BusConfigAsync(const Arguments&);
 
 private:
+  static bool DeviceByIdAssertParams(const Arguments&);
   static bool AssertUpdaterExists(const Arguments&);
   static bool AssertUpdaterValue(const Arguments&);
 
   static std::string GetUpdaterName(const Arguments&);
   static bool ExecuteUpdater(const Arguments&);
 
+  static bool BusConfigAssertParams(const Arguments&);
+  static int  GetPullupParam(const Arguments&, const char*);
+  static void ExecuteBusConfig(Bus*, int, int);
+  static Handle<Object> BusConfigToV8Object(Bus*);
+
+  friend class DeviceByIdJob;
+  friend class BusConfigJob;
+
 };
 
 
@@ -0,0 +1,173 @@
+#include "bench.h"
+#include "bench_rig.h"
+#include "../controller/controller.h"
+#include "../device/device.h"
+#include "../device/lib/crc.h"
+#include "../device/lib/sha33.h"
+#include "../master/bus/search.h"
+#include "../shared/v8_helper.h"
+#include "../shared/util.h"
+#include <node.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+
+using namespace v8;
+
+#define BO_ITERATIONS 	  "iterations"
+#define BO_BUSES		  "buses"
+#define BO_DEVICES		  "devices"
+#define BO_EMULATE_TIMING "emulateTiming"
+
+#define MAX_BENCH_BUSES		8
+#define MAX_BENCH_DEVICES	1000
+
+
+void Bench::Init(Handle<Object> target) {
+	target->Set(String::NewSymbol("run"), FunctionTemplate::New(Run)->GetFunction());
+}
+
+
+//Options: iterations, buses, devices (per bus), emulateTiming
+Handle<Value> Bench::Run(const Arguments& args) {
+	HandleScope scope;
+
+	Handle<Value> options = args.Length() > 0 ? args[0] : Handle<Value>(Object::New());
+	int iterations 	  = GetIntOption(options, BO_ITERATIONS, 10);
+	int busCount   	  = GetIntOption(options, BO_BUSES, 1);
+	int devicesPerBus = GetIntOption(options, BO_DEVICES, 20);
+	bool timing 	  = V8Helper::V8ObjectHasKey(options, BO_EMULATE_TIMING) && V8Helper::GetBoolFromV8Object(options, BO_EMULATE_TIMING);
+
+	bool valid = iterations > 0 && busCount > 0 && busCount <= MAX_BENCH_BUSES && devicesPerBus > 0 && devicesPerBus <= MAX_BENCH_DEVICES;
+	Util::ThrowExceptionIf(!valid, "Invalid options, allowed: %s > 0, %s 1..%d, %s 1..%d", BO_ITERATIONS, BO_BUSES, MAX_BENCH_BUSES, BO_DEVICES, MAX_BENCH_DEVICES);
+
+	if (!valid)
+		return scope.Close(Undefined());
+
+	std::vector<BenchResult> results;
+	RunLibScenarios(&results, iterations);
+
+	BenchRig simulated(false, busCount, devicesPerBus, false);
+	RunMasterScenarios(&results, &simulated, "simulated", iterations);
+
+	BenchRig emulated(true, busCount, devicesPerBus, timing);
+	RunMasterScenarios(&results, &emulated, "emulated", iterations);
+
+	Handle<Array> list = Array::New(results.size());
+
+	for (unsigned int i=0; i < results.size(); i++)
+		list->Set(i, ResultToV8Object(&results[i]));
+
+	return scope.Close(list);
+}
+
+
+//private
+
+//CRC and SHA run for every read and every authenticated access
+void Bench::RunLibScenarios(std::vector<BenchResult>* results, int iterations){
+
+	uint8_t bytes[64];
+	uint32_t hash[5];
+
+	for (int i=0; i<64; i++)
+		bytes[i] = (uint8_t) (i * 7);
+
+	results->push_back(Measure("crc8", "lib", iterations * 1000, NULL, [&](){
+		bytes[0] = Crc::Build8Bit(bytes, 9);
+	}));
+
+	results->push_back(Measure("crc16", "lib", iterations * 1000, NULL, [&](){
+		bytes[1] = (uint8_t) Crc::Build16Bit(bytes, 32);
+	}));
+
+	results->push_back(Measure("sha33", "lib", iterations * 100, NULL, [&](){
+		Sha33::ComputeSHAVM(bytes, hash);
+		bytes[2] = (uint8_t) hash[0];
+	}));
+
+}
+
+
+//Sync first, the read scenario needs the devices in the store
+void Bench::RunMasterScenarios(std::vector<BenchResult>* results, BenchRig* rig, const char* masterType, int iterations){
+
+	Controller* controller = rig->GetController();
+	Bus* bus = rig->GetMaster()->GetBus(0);
+
+	results->push_back(Measure("sync", masterType, iterations, rig, [&](){
+		controller->SyncAllDevices(false, false);
+	}));
+
+	results->push_back(Measure("search", masterType, iterations, rig, [&](){
+		Search search(bus, false);
+		search.Execute(0);
+	}));
+
+	std::vector<Device*> devices = rig->GetDevices();
+
+	results->push_back(Measure("readValues", masterType, iterations, rig, [&](){
+		for (unsigned int i=0; i < devices.size(); i++)
+			devices[i]->ReadAndVerify(DDT_VALUES);
+	}));
+
+	results->push_back(Measure("readAll", masterType, iterations, rig, [&](){
+		for (unsigned int i=0; i < devices.size(); i++)
+			devices[i]->ReadAndVerify(DDT_VALUES | DDT_PROPERTIES);
+	}));
+
+}
+
+
+BenchResult Bench::Measure(const char* name, const char* group, int iterations, BenchRig* rig, std::function<void(void)> fn){
+
+	BenchResult result = BenchResult();
+	WireCounters wireBefore = rig == NULL ? WireCounters() : rig->GetWireCounters();
+	uint64_t transactionsBefore = rig == NULL ? 0 : rig->GetTransactionCount();
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int i=0; i<iterations; i++)
+		fn();
+
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+	result.name 	  = std::string(group) + "/" + name;
+	result.iterations = iterations;
+	result.wallMs 	  = elapsed.count();
+
+	if (rig != NULL){
+		WireCounters wireAfter = rig->GetWireCounters();
+		result.transactions 	  = rig->GetTransactionCount() - transactionsBefore;
+		result.wire.resets 		  = wireAfter.resets - wireBefore.resets;
+		result.wire.bytesWritten  = wireAfter.bytesWritten - wireBefore.bytesWritten;
+		result.wire.bytesRead 	  = wireAfter.bytesRead - wireBefore.bytesRead;
+		result.wire.triplets 	  = wireAfter.triplets - wireBefore.triplets;
+	}
+
+	return result;
+}
+
+
+Handle<Object> Bench::ResultToV8Object(BenchResult* result){
+
+	Handle<Object> object = Object::New();
+
+	V8Helper::AddPairToV8Object(object, "name", 			&result->name);
+	V8Helper::AddPairToV8Object(object, "iterations", 		result->iterations);
+	V8Helper::AddPairToV8Object(object, "wallMs", 			Number::New(result->wallMs));
+	V8Helper::AddPairToV8Object(object, "i2cTransactions", Number::New(result->transactions));
+	V8Helper::AddPairToV8Object(object, "resets", 			Number::New(result->wire.resets));
+	V8Helper::AddPairToV8Object(object, "bytesWritten", 	Number::New(result->wire.bytesWritten));
+	V8Helper::AddPairToV8Object(object, "bytesRead", 		Number::New(result->wire.bytesRead));
+	V8Helper::AddPairToV8Object(object, "triplets", 		Number::New(result->wire.triplets));
+
+	return object;
+}
+
+
+int Bench::GetIntOption(Handle<Value> options, const char* key, int defaultValue){
+	return V8Helper::V8ObjectHasKey(options, key) ? V8Helper::GetIntFromV8Object(options, key) : defaultValue;
+}
@@ -0,0 +1,43 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "bench_rig.h"
+#include "../master/sim/virtual_wire.h"
+#include <node.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <functional>
+
+using namespace v8;
+
+
+// Counters are the difference between before and after the scenario
+typedef struct {
+	std::string name;
+	int iterations;
+	double wallMs;
+	uint64_t transactions;
+	WireCounters wire;
+} BenchResult;
+
+
+// Benchmark scenarios for the library and the drivers, exported by the
+// w1direct_bench addon. Run with "node bench/run.js".
+class Bench {
+
+  public:
+	static void Init(Handle<Object>);
+	static Handle<Value> Run(const Arguments&);
+
+
+  private:
+	static void RunLibScenarios(std::vector<BenchResult>*, int);
+	static void RunMasterScenarios(std::vector<BenchResult>*, BenchRig*, const char*, int);
+	static BenchResult Measure(const char*, const char*, int, BenchRig*, std::function<void(void)>);
+	static Handle<Object> ResultToV8Object(BenchResult*);
+	static int GetIntOption(Handle<Value>, const char*, int);
+};
+
+
+#endif
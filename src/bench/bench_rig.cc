@@ -0,0 +1,128 @@
+#include "bench_rig.h"
+#include "../master/ds2482.h"
+#include "../master/sim/simulated_master.h"
+#include "../master/sim/virtual_device.h"
+#include "../device/lib/crc.h"
+#include "../shared/util.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#define RIG_MASTER_NAME "bench"
+
+//Device mix on each wire, repeated
+static const uint8_t families[4] = { 0x28, 0x28, 0x10, 0x29 };
+
+
+BenchRig::BenchRig(bool emulated, int busCount, int devicesPerBus, bool emulateTiming) : emulator(NULL) {
+
+	std::string name = RIG_MASTER_NAME;
+	std::string devFile = "emulator";
+
+	if (emulated){
+		std::string subType = busCount > 1 ? "800" : "100";
+		emulator = new Ds2482Emulator(busCount > 1 ? 8 : 1, emulateTiming);
+		wires    = emulator->GetWires();
+
+		DS2482* ds2482 = new DS2482(&name, &subType, emulator);
+		ds2482->Initialize(&devFile, 0);
+		master = ds2482;
+
+	} else {
+		::SimulatedMaster* simulated = new ::SimulatedMaster(&name, busCount);
+		wires  = simulated->GetWires();
+		master = simulated;
+	}
+
+	AddVirtualDevices(busCount, devicesPerBus);
+
+	controller = new Controller();
+	controller->AddMaster(master->GetName(), master);
+}
+
+
+BenchRig::~BenchRig(void){
+	delete controller;
+	delete master;
+}
+
+
+Controller* BenchRig::GetController(void){
+	return controller;
+}
+
+
+Master* BenchRig::GetMaster(void){
+	return master;
+}
+
+
+//Only devices already synced are returned
+std::vector<Device*> BenchRig::GetDevices(void){
+
+	std::vector<Device*> devices;
+	DeviceStore* store = controller->GetDeviceStore();
+
+	for (unsigned int i=0; i < deviceIds.size(); i++){
+		if (store->HasDevice(deviceIds[i]))
+			devices.push_back(store->GetDevice(deviceIds[i]));
+	}
+
+	return devices;
+}
+
+
+//I2C transactions, 0 for the simulated master
+uint64_t BenchRig::GetTransactionCount(void){
+	return emulator == NULL ? 0 : emulator->GetTransactionCount();
+}
+
+
+//Sum over all wires of the master
+WireCounters BenchRig::GetWireCounters(void){
+
+	WireCounters total = WireCounters();
+	std::vector<VirtualWire*>::iterator it;
+
+	for (it = wires->begin(); it != wires->end(); ++it){
+		WireCounters* counters = (*it)->GetCounters();
+		total.resets 	   += counters->resets;
+		total.bytesWritten += counters->bytesWritten;
+		total.bytesRead    += counters->bytesRead;
+		total.triplets     += counters->triplets;
+	}
+
+	return total;
+}
+
+
+//Family code in the lowest byte, crc8 in the highest byte
+uint64_t BenchRig::BuildRomId(uint8_t family, uint32_t serial){
+
+	uint8_t bytes[7] = { family, (uint8_t) serial, (uint8_t) (serial >> 8), (uint8_t) (serial >> 16), (uint8_t) (serial >> 24), 0x00, 0x00 };
+	uint64_t romId = 0;
+
+	for (int i=0; i<7; i++)
+		romId |= ((uint64_t) bytes[i]) << (i * 8);
+
+	return romId | (((uint64_t) Crc::Build8Bit(bytes, 7)) << 56);
+}
+
+
+//private
+
+//A DS2482-800 has 8 channels, only the requested ones get devices
+void BenchRig::AddVirtualDevices(int busCount, int devicesPerBus){
+
+	uint32_t serial = 1;
+
+	for (int b=0; b < busCount; b++){
+		for (int i=0; i < devicesPerBus; i++, serial++){
+			uint64_t romId = BuildRomId(families[i % 4], serial);
+			wires->at(b)->AddDevice(VirtualDevice::New(romId));
+			deviceIds.push_back(romId);
+		}
+	}
+
+}
@@ -0,0 +1,44 @@
+#ifndef BENCH_RIG_H
+#define BENCH_RIG_H
+
+#include "../controller/controller.h"
+#include "../device/device.h"
+#include "../master/master.h"
+#include "../master/sim/virtual_wire.h"
+#include "../master/transport/ds2482_emulator.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+
+// Controller with one master on virtual wires. The master is either a
+// SimulatedMaster or the DS2482 driver on top of a Ds2482Emulator, so the
+// same scenario can be run with and without the I2C register layer.
+class BenchRig {
+
+  public:
+	BenchRig(bool, int, int, bool);
+	~BenchRig(void);
+
+	Controller* GetController(void);
+	Master* GetMaster(void);
+	std::vector<Device*> GetDevices(void);
+
+	uint64_t GetTransactionCount(void);
+	WireCounters GetWireCounters(void);
+
+	static uint64_t BuildRomId(uint8_t, uint32_t);
+
+
+  private:
+	void AddVirtualDevices(int, int);
+
+	Controller* controller;
+	Master* master;
+	Ds2482Emulator* emulator;
+	std::vector<VirtualWire*>* wires;
+	std::vector<uint64_t> deviceIds;
+};
+
+
+#endif
@@ -0,0 +1,10 @@
+#include <node.h>
+#include "bench.h"
+
+using namespace v8;
+
+void InitAll(Handle<Object> exports) {
+  Bench::Init(exports);
+}
+
+NODE_MODULE(w1direct_bench, InitAll)
@@ -10,12 +10,25 @@
 #include <vector>
 #include <stdint.h>
 #include <string>
+#include <thread>
 
 
 
 Controller::Controller(void) {
 	deviceStore = new DeviceStore();
 	syncId = 0;
+	readGroupId = 0;
+}
+
+
+//The masters are owned by the caller
+Controller::~Controller(void) {
+	std::map<int, ReadGroup*>::iterator it;
+
+	for(it = readGroups.begin(); it != readGroups.end(); it++)
+		delete it->second;
+
+	delete deviceStore;
 }
 
 
@@ -34,65 +47,236 @@ bool Controller::HasMaster(std::string* name){
 }
 
 
-void Controller::SyncAllDevices(void) {
+void Controller::SyncAllDevices(bool parallel, bool detectOverdrive) {
 	std::map<std::string, Master*>::iterator itM;
 
+	if (parallel)
+		return SyncAllDevicesParallel(detectOverdrive);
+
 	for (itM = masters.begin(); itM != masters.end(); ++itM)
-		SyncMasterDevices(itM->second);
+		SyncMasterDevices(itM->second, detectOverdrive);
 
 }
 
 
-void Controller::SyncMasterDevices(Master* master) {
+void Controller::SyncMasterDevices(Master* master, bool detectOverdrive) {
 	std::vector<Bus*>::iterator itB;
 	std::vector<Bus*> *buses = master->GetBuses();
 
 	for (itB = buses->begin(); itB !=buses->end(); ++itB)
-		SyncBusDevices(*itB);
+		SyncBusDevices(*itB, detectOverdrive, 0);
+
+}
+
+
+//With maxDevices the search stops after as many new devices, the next
+//call continues it. Returns true when the search of the bus finished.
+bool Controller::SyncBusDevices(Bus* bus, bool detectOverdrive, int maxDevices) {
+
+	std::vector<uint64_t> deviceIds = SearchBusDevices(bus, maxDevices);
+	std::vector<Device*> newDevices;
+
+	MergeBusDevices(bus, &deviceIds, &newDevices);
+	SetupDevices(&newDevices, detectOverdrive);
+
+	return !bus->IsSearchPending();
+}
+
+
+//The device store is not changed, found devices may be unknown to it
+std::vector<uint64_t> Controller::FindAllDevices(int familyCode, bool alarmOnly) {
+
+	std::vector<uint64_t> deviceIds;
+	std::map<std::string, Master*>::iterator itM;
+	std::vector<Bus*>::iterator itB;
+
+	for (itM = masters.begin(); itM != masters.end(); ++itM){
+		std::vector<Bus*> *buses = itM->second->GetBuses();
+
+		for (itB = buses->begin(); itB != buses->end(); ++itB){
+			std::vector<uint64_t> busDeviceIds = FindBusDevices(*itB, familyCode, alarmOnly);
+			deviceIds.insert(deviceIds.end(), busDeviceIds.begin(), busDeviceIds.end());
+		}
+	}
+
+	return deviceIds;
+}
+
+
+std::vector<uint64_t> Controller::FindBusDevices(Bus* bus, int familyCode, bool alarmOnly) {
+
+	//like on sync, the search runs in standard speed
+	bus->SetOverdriveSpeed(false);
+
+	return bus->FindDeviceIds(familyCode, alarmOnly);
+}
+
+
+DeviceStore* Controller::GetDeviceStore(void){
+	return deviceStore;
+}
+
+
+//Returns the id of the group, ids are not reused
+int Controller::AddReadGroup(ReadGroup* readGroup){
+	readGroups[++readGroupId] = readGroup;
+	return readGroupId;
+}
+
+
+bool Controller::HasReadGroup(int id){
+	return readGroups.find(id) != readGroups.end();
+}
+
+
+ReadGroup* Controller::GetReadGroup(int id){
+	return readGroups[id];
+}
+
+
+void Controller::RemoveReadGroup(int id){
+	delete readGroups[id];
+	readGroups.erase(id);
+}
+
+
+//Each master has its own file descriptor, so masters are searched at
+//the same time. The device store is only updated from the calling thread.
+void Controller::SyncAllDevicesParallel(bool detectOverdrive) {
+
+	std::vector<Master*> syncMasters;
+	std::vector<std::thread> threads;
+	std::map<std::string, Master*>::iterator itM;
+
+	for (itM = masters.begin(); itM != masters.end(); ++itM)
+		syncMasters.push_back(itM->second);
+
+	std::vector<std::vector<std::vector<uint64_t> > > deviceIds(syncMasters.size());
+	std::vector<std::vector<Device*> > newDevices(syncMasters.size());
+
+	//1. search, one thread per master
+	for (unsigned int i = 0; i < syncMasters.size(); i++)
+		threads.push_back(std::thread(SearchMasterDevices, syncMasters[i], &deviceIds[i]));
 
+	JoinThreads(&threads);
+
+	//2. merge
+	for (unsigned int i = 0; i < syncMasters.size(); i++){
+		std::vector<Bus*> *buses = syncMasters[i]->GetBuses();
+
+		for (unsigned int b = 0; b < buses->size(); b++)
+			MergeBusDevices(buses->at(b), &deviceIds[i][b], &newDevices[i]);
+	}
+
+	//3. initialize new devices, one thread per master
+	for (unsigned int i = 0; i < syncMasters.size(); i++)
+		threads.push_back(std::thread(SetupDevices, &newDevices[i], detectOverdrive));
+
+	JoinThreads(&threads);
 }
 
 
-void Controller::SyncBusDevices(Bus* bus) {
+//Without maxDevices a new search of the whole bus is started
+std::vector<uint64_t> Controller::SearchBusDevices(Bus* bus, int maxDevices){
 
 	//overdrive must be disabled on sync
 	bus->SetOverdriveSpeed(false);
 
-	std::vector<uint64_t> deviceIds = bus->SearchDeviceIds(false);
+	return maxDevices > 0 ? bus->SearchDeviceIds(false, maxDevices) : bus->SearchDeviceIds(false);
+}
+
+
+void Controller::SearchMasterDevices(Master* master, std::vector<std::vector<uint64_t> >* deviceIds){
+	std::vector<Bus*>::iterator itB;
+	std::vector<Bus*> *buses = master->GetBuses();
+
+	for (itB = buses->begin(); itB !=buses->end(); ++itB)
+		deviceIds->push_back(SearchBusDevices(*itB, 0));
+
+}
+
+
+void Controller::MergeBusDevices(Bus* bus, std::vector<uint64_t>* deviceIds, std::vector<Device*>* newDevices){
+
 	std::vector<uint64_t>::iterator it;
-	syncId+=1;
 
-	for(it = deviceIds.begin(); it != deviceIds.end(); it++)
-		SyncFoundBusDevice(bus, *it);
+	//all parts of a continued search share the sync id of the first one
+	if (!bus->IsSearchContinued())
+		busSyncIds[bus] = ++syncId;
+
+	uint64_t busSyncId = busSyncIds[bus];
+
+	for(it = deviceIds->begin(); it != deviceIds->end(); it++)
+		SyncFoundBusDevice(bus, *it, busSyncId, newDevices);
+
+	//devices not found yet are only removed after the last part
+	if (bus->IsSearchPending())
+		return;
 
-	deviceStore->RemoveBusDeviceIf(bus, &syncId, CheckDeviceDeletion);
+	deviceStore->RemoveBusDeviceIf(bus, &busSyncId, CheckDeviceDeletion);
+	InvalidateReadGroups();
+
+	//device commands skip the ROM id on buses with one device
+	std::vector<Device*> busDevices = deviceStore->GetBusDevices(bus);
+	bus->SetSoleDeviceId(busDevices.size() == 1 ? busDevices.front()->GetIntId() : 0);
 }
 
 
-DeviceStore* Controller::GetDeviceStore(void){
-	return deviceStore;
+//Removed devices are deleted with the next sync, groups holding one
+//of them are invalid from now on
+void Controller::InvalidateReadGroups(void){
+	std::map<int, ReadGroup*>::iterator it;
+
+	for (it = readGroups.begin(); it != readGroups.end(); ++it)
+		it->second->InvalidateIfContains(deviceStore->GetChanges(CHG_REMOVED));
+
 }
 
 
-void Controller::SyncFoundBusDevice(Bus* bus, uint64_t intDeviceId){
+void Controller::SyncFoundBusDevice(Bus* bus, uint64_t intDeviceId, uint64_t busSyncId, std::vector<Device*>* newDevices){
 
-	Device* device;
-	std::string strDeviceId = Util::UInt64ToHexStr(intDeviceId);
+	Device* device = deviceStore->GetDevice(intDeviceId);
 
-	if (!deviceStore->HasDevice(&strDeviceId)){
+	//the hex id is only built for new devices
+	if (device == NULL){
+		std::string strDeviceId = Util::UInt64ToHexStr(intDeviceId);
 		device = NewDevice(bus, intDeviceId, &strDeviceId);
-		deviceStore->AddDevice(&strDeviceId, device);
-		device->AfterNewSearched(syncId);
+		deviceStore->AddDevice(device);
+		device->AfterNewSearched(busSyncId);
+		newDevices->push_back(device);
 
 	} else {
-		device = deviceStore->GetDevice(&strDeviceId);
 		deviceStore->AddChange(CHG_UPDATED, device);
-		device->AfterAgainSearched(syncId);
+		device->AfterAgainSearched(busSyncId);
 	}
 
 }
 
 
+//New devices may be probed for overdrive right after their setup
+void Controller::SetupDevices(std::vector<Device*>* devices, bool detectOverdrive){
+	std::vector<Device*>::iterator it;
+
+	for(it = devices->begin(); it != devices->end(); it++){
+		(*it)->Setup();
+
+		if (detectOverdrive)
+			(*it)->DetectOverdrive();
+	}
+
+}
+
+
+void Controller::JoinThreads(std::vector<std::thread>* threads){
+	std::vector<std::thread>::iterator it;
+
+	for(it = threads->begin(); it != threads->end(); it++)
+		it->join();
+
+	threads->clear();
+}
+
+
 bool Controller::CheckDeviceDeletion(Device* busDevice, void* args){
 	return busDevice->GetSyncId() != *((uint64_t*) args);
 }
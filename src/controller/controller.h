@@ -2,10 +2,13 @@
 #define CONTROLLER_H
 
 #include "device_store.h"
+#include "read_group.h"
 #include "../master/master.h"
 #include "../device/device.h"
 #include <map>
 #include <string>
+#include <vector>
+#include <thread>
 #include <stdint.h>
 
 
@@ -13,25 +16,45 @@ class Controller {
 
   public:
 	Controller(void);
+	~Controller(void);
     void AddMaster(std::string*, Master*);
     Master* GetMaster(std::string*);
     bool HasMaster(std::string*);
 
-    void SyncAllDevices(void);
-    void SyncMasterDevices(Master*);
-   	void SyncBusDevices(Bus*);
+    void SyncAllDevices(bool, bool);
+    void SyncMasterDevices(Master*, bool);
+   	bool SyncBusDevices(Bus*, bool, int);
+
+   	std::vector<uint64_t> FindAllDevices(int, bool);
+   	std::vector<uint64_t> FindBusDevices(Bus*, int, bool);
 
    	DeviceStore* GetDeviceStore(void);
+
+   	int  AddReadGroup(ReadGroup*);
+   	bool HasReadGroup(int);
+   	ReadGroup* GetReadGroup(int);
+   	void RemoveReadGroup(int);
    	std::map<std::string, Master*> masters;
 
 
   private:
-   	void SyncFoundBusDevice(Bus*, uint64_t);
+    void SyncAllDevicesParallel(bool);
+   	void MergeBusDevices(Bus*, std::vector<uint64_t>*, std::vector<Device*>*);
+   	void InvalidateReadGroups(void);
+   	void SyncFoundBusDevice(Bus*, uint64_t, uint64_t, std::vector<Device*>*);
    	Device* NewDevice(Bus*, uint64_t, std::string*);
+
+   	static std::vector<uint64_t> SearchBusDevices(Bus*, int);
+   	static void SearchMasterDevices(Master*, std::vector<std::vector<uint64_t> >*);
+   	static void SetupDevices(std::vector<Device*>*, bool);
+   	static void JoinThreads(std::vector<std::thread>*);
    	static bool CheckDeviceDeletion(Device*, void*);
 
     DeviceStore* deviceStore;
     uint64_t syncId;
+    std::map<Bus*, uint64_t> busSyncIds;
+    std::map<int, ReadGroup*> readGroups;
+    int readGroupId;
 
 
 };
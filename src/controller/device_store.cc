@@ -1,46 +1,68 @@
 #include "device_store.h"
 #include "../device/device.h"
 #include "../master/bus/bus.h"
-#include <string>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
 
 
-Device* DeviceStore::GetDevice(std::string* strDeviceId){
-	return devices[*strDeviceId];
-}
+//Removed devices are only kept in the changes until the next reset
+DeviceStore::~DeviceStore(void){
+	std::unordered_map<uint64_t, Device*>::iterator it;
 
+	for(it = devices.begin(); it != devices.end(); it++)
+		delete it->second;
 
-bool DeviceStore::HasDevice(std::string* deviceId){
-	return devices.find(*deviceId) != devices.end();
+	ResetAllChanges(true);
 }
 
 
+//NULL if the device is unknown
+Device* DeviceStore::GetDevice(uint64_t intDeviceId){
+	std::unordered_map<uint64_t, Device*>::iterator it = devices.find(intDeviceId);
+	return it != devices.end() ? it->second : NULL;
+}
+
 
-void DeviceStore::AddDevice(std::string* strDeviceId, Device* device){
-	devices[*strDeviceId] = device;
-	AddChange(CHG_ADDED, device);
+bool DeviceStore::HasDevice(uint64_t intDeviceId){
+	return devices.find(intDeviceId) != devices.end();
 }
 
 
-void DeviceStore::RemoveDevice(std::string* strDeviceId){
-	Device* device = GetDevice(strDeviceId);
-	devices.erase(*strDeviceId);
-	AddChange(CHG_REMOVED, device);
+//The bus list stays in order of the device ids
+void DeviceStore::AddDevice(Device* device){
+	std::vector<Device*>* list = &busDevices[device->GetBus()];
+
+	devices[device->GetIntId()] = device;
+	list->insert(std::upper_bound(list->begin(), list->end(), device, PrecedesById), device);
+	AddChange(CHG_ADDED, device);
 }
 
 
+//Only the devices of the bus are checked
 void DeviceStore::RemoveBusDeviceIf(Bus* bus, void* opts, bool (*cb)(Device*, void* opts)){
 
-	std::map<std::string, Device*>::iterator it;
-	bool match, delDev;
-	Device *device;
+	std::vector<Device*>* list = &busDevices[bus];
+	std::vector<Device*> kept;
+	std::vector<Device*>::iterator it;
+
+	for(it = list->begin(); it != list->end(); it++){
 
-	for(it = devices.begin(); it != devices.end(); it++){
-		device = it->second;
-		match  = device->GetBus() == bus;
-		delDev = match && cb(it->second, opts);
-		if (delDev) RemoveDevice(device->GetStrId());
+		if (cb(*it, opts)){
+			devices.erase((*it)->GetIntId());
+			AddChange(CHG_REMOVED, *it);
+
+		} else
+			kept.push_back(*it);
 	}
 
+	list->swap(kept);
+}
+
+
+//In order of the device ids
+std::vector<Device*> DeviceStore::GetBusDevices(Bus* bus){
+	return busDevices[bus];
 }
 
 
@@ -68,6 +90,20 @@ void DeviceStore::ResetAllChanges(bool deleteRemovedDevices){
 }
 
 
+//private
 
+//Same order as the hex strings of the ids, their first byte is the lowest
+bool DeviceStore::PrecedesById(Device* a, Device* b){
+	uint64_t idA = a->GetIntId();
+	uint64_t idB = b->GetIntId();
 
+	for (int i = 0; i < 8; i++){
+		uint8_t byteA = (uint8_t) (idA >> 8*i);
+		uint8_t byteB = (uint8_t) (idB >> 8*i);
 
+		if (byteA != byteB)
+			return byteA < byteB;
+	}
+
+	return false;
+}
@@ -4,22 +4,26 @@
 #include "../device/device.h"
 #include "../master/bus/bus.h"
 #include <map>
-#include <string>
+#include <unordered_map>
 #include <vector>
+#include <stdint.h>
 
 #define CHG_ADDED   0
 #define CHG_UPDATED 1
 #define CHG_REMOVED 2
 
 
+// Devices by their 64 bit ROM id. Each bus has its own device list, so
+// a bus is merged on sync without scanning the devices of other buses.
 class DeviceStore {
 
   public:
-	Device* GetDevice(std::string*);
-	void AddDevice(std::string*, Device*);
-	bool HasDevice(std::string*);
-	void RemoveDevice(std::string*);
+	~DeviceStore(void);
+	Device* GetDevice(uint64_t);
+	void AddDevice(Device*);
+	bool HasDevice(uint64_t);
 	void RemoveBusDeviceIf(Bus*, void*, bool (*cb)(Device*, void* opts));
+	std::vector<Device*> GetBusDevices(Bus*);
 
 	void AddChange(const int, Device*);
 	std::vector<Device*>* GetChanges(int);
@@ -27,17 +31,13 @@ class DeviceStore {
 
 
   private:
-	std::map<std::string, Device*> devices;
+	static bool PrecedesById(Device*, Device*);
+
+	std::unordered_map<uint64_t, Device*> devices;
+	std::map<Bus*, std::vector<Device*> > busDevices;
 	std::vector<Device*> changes[3];
 
 };
 
 
 #endif
-
-
-
-
-
-
-
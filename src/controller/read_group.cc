@@ -0,0 +1,60 @@
+#include "read_group.h"
+#include "read_planner.h"
+#include "../device/device.h"
+#include <vector>
+#include <algorithm>
+
+
+ReadGroup::ReadGroup(std::vector<Device*>* devices, int fields)
+	: devices(*devices), fields(fields), valid(true)
+{
+	Plan();
+}
+
+
+std::vector<Device*>* ReadGroup::GetDevices(void){
+	return &devices;
+}
+
+
+int ReadGroup::GetFields(void){
+	return fields;
+}
+
+
+bool ReadGroup::IsValid(void){
+	return valid;
+}
+
+
+void ReadGroup::InvalidateIfContains(std::vector<Device*>* removedDevices){
+
+	for (unsigned int i=0; valid && i < removedDevices->size(); i++)
+		valid = std::find(devices.begin(), devices.end(), removedDevices->at(i)) == devices.end();
+
+}
+
+
+//Speeds change by an update, a sync with detectOverdrive or after CRC
+//failures in overdrive. Only called on a valid group.
+void ReadGroup::PlanIfSpeedChanged(void){
+
+	for (unsigned int i=0; i < devices.size(); i++){
+		if (devices[i]->HasOverdriveSpeed() != plannedSpeeds[i]){
+			Plan();
+			return;
+		}
+	}
+
+}
+
+
+void ReadGroup::Plan(void){
+	ReadPlanner planner;
+	planner.Plan(&devices);
+
+	plannedSpeeds.clear();
+
+	for (unsigned int i=0; i < devices.size(); i++)
+		plannedSpeeds.push_back(devices[i]->HasOverdriveSpeed());
+}
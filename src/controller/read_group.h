@@ -0,0 +1,34 @@
+#ifndef READ_GROUP_H
+#define READ_GROUP_H
+
+#include "../device/device.h"
+#include <vector>
+
+
+// Devices and fields of a repeated read, resolved and planned once.
+// A sync which removes one of the devices invalidates the group, its
+// device pointers are not used anymore then. A speed change of one of
+// the devices only invalidates the plan, it is planned again.
+class ReadGroup {
+
+  public:
+	ReadGroup(std::vector<Device*>*, int);
+
+	std::vector<Device*>* GetDevices(void);
+	int  GetFields(void);
+	bool IsValid(void);
+	void InvalidateIfContains(std::vector<Device*>*);
+	void PlanIfSpeedChanged(void);
+
+
+  private:
+	void Plan(void);
+
+	std::vector<Device*> devices;
+	std::vector<bool> plannedSpeeds;
+	int  fields;
+	bool valid;
+};
+
+
+#endif
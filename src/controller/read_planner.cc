@@ -0,0 +1,74 @@
+#include "read_planner.h"
+#include "../device/device.h"
+#include "../master/master.h"
+#include "../master/bus/bus.h"
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <functional>
+
+
+//A bus starts with the speed the previous bus of its master ended with,
+//so the speed changes at most once per bus
+void ReadPlanner::Plan(std::vector<Device*>* devices){
+
+	unsigned int begin, end;
+	std::stable_sort(devices->begin(), devices->end(), Precedes);
+
+	for (begin = 0; begin < devices->size(); begin = end){
+		Bus* bus = devices->at(begin)->GetBus();
+
+		for (end = begin + 1; end < devices->size() && devices->at(end)->GetBus() == bus; end++);
+
+		if (begin > 0 && devices->at(begin - 1)->GetBus()->GetMaster() == bus->GetMaster() && devices->at(begin - 1)->HasOverdriveSpeed())
+			std::stable_partition(devices->begin() + begin, devices->begin() + end, std::mem_fn(&Device::HasOverdriveSpeed));
+	}
+}
+
+
+//A master starts on its selected bus, the speed of its first device
+//is not counted
+ReadCost ReadPlanner::EstimateCost(std::vector<Device*>* devices){
+
+	ReadCost cost = {0, 0};
+	std::map<Master*, Bus*> lastBus;
+	std::map<Master*, bool> lastSpeed;
+
+	for (unsigned int i=0; i < devices->size(); i++){
+		Bus* bus 	   = devices->at(i)->GetBus();
+		Master* master = bus->GetMaster();
+		bool overdrive = devices->at(i)->HasOverdriveSpeed();
+
+		if (lastBus.count(master) == 0)
+			cost.channelSelects += (master->GetSelectedBus() != bus) ? 1 : 0;
+		else
+			cost.channelSelects += (lastBus[master] != bus) ? 1 : 0;
+
+		if (lastSpeed.count(master) > 0 && lastSpeed[master] != overdrive)
+			cost.speedChanges++;
+
+		lastBus[master]   = bus;
+		lastSpeed[master] = overdrive;
+	}
+
+	return cost;
+}
+
+
+//private
+
+//Strict weak ordering by "master->bus->speed", standard speed first
+bool ReadPlanner::Precedes(Device* a, Device* b){
+
+	Bus* busA = a->GetBus();
+	Bus* busB = b->GetBus();
+	int nameCmp = busA->GetMaster()->GetName()->compare(*busB->GetMaster()->GetName());
+
+	if (nameCmp != 0)
+		return nameCmp < 0;
+
+	if (busA->GetNumber() != busB->GetNumber())
+		return busA->GetNumber() < busB->GetNumber();
+
+	return !a->HasOverdriveSpeed() && b->HasOverdriveSpeed();
+}
@@ -0,0 +1,32 @@
+#ifndef READ_PLANNER_H
+#define READ_PLANNER_H
+
+#include "../device/device.h"
+#include "../master/master.h"
+#include <vector>
+
+
+// Estimated master operations of a read order
+typedef struct {
+	int channelSelects;
+	int speedChanges;
+} ReadCost;
+
+
+// Orders devices for a multi device read: grouped by master, then bus,
+// then speed. Each master is done in one pass, so a channel is selected
+// once per bus and the speed changes at most once per bus. The request
+// order is kept within a group.
+class ReadPlanner {
+
+  public:
+	void Plan(std::vector<Device*>*);
+	ReadCost EstimateCost(std::vector<Device*>*);
+
+
+  private:
+	static bool Precedes(Device*, Device*);
+};
+
+
+#endif
@@ -0,0 +1,215 @@
+#include "temperature_engine.h"
+#include "device_store.h"
+#include "../device/device.h"
+#include "../master/bus/bus.h"
+#include "../master/master.h"
+#include <vector>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#define CMD_TCONV			0x44
+#define POLL_INTERVAL_MS	2
+
+
+TemperatureEngine::TemperatureEngine(DeviceStore* deviceStore)
+	: deviceStore(deviceStore)
+{}
+
+
+//Resolutions in bit, all sensors if empty
+void TemperatureEngine::SetResolutions(std::vector<int>* resolutions){
+	this->resolutions = *resolutions;
+}
+
+
+void TemperatureEngine::ConvertAndRead(std::vector<Bus*>* buses){
+
+	std::vector<Bus*> pending;
+
+	//buses without sensors are left out
+	for (unsigned int i=0; i < buses->size(); i++){
+		if (!GetSensors(buses->at(i), true).empty())
+			pending.push_back(buses->at(i));
+	}
+
+	while (!pending.empty())
+		pending = ConvertRound(&pending);
+}
+
+
+std::map<int, TemperatureGroup> TemperatureEngine::GetGroups(std::vector<Bus*>* buses){
+
+	std::map<int, TemperatureGroup> groups;
+
+	for (unsigned int i=0; i < buses->size(); i++){
+		std::vector<Device*> sensors = GetSensors(buses->at(i), true);
+
+		for (unsigned int j=0; j < sensors.size(); j++){
+			TemperatureGroup* group = &groups[sensors[j]->GetResolution()];
+
+			if (group->devices.empty() || sensors[j]->GetConversionTime() > group->conversionTime)
+				group->conversionTime = sensors[j]->GetConversionTime();
+
+			group->devices.push_back(sensors[j]);
+		}
+	}
+
+	return groups;
+}
+
+
+std::vector<Device*>* TemperatureEngine::GetDevices(void){
+	return &devices;
+}
+
+
+std::vector<bool>* TemperatureEngine::GetVerified(void){
+	return &verified;
+}
+
+
+//private
+
+//Returns the buses left for the next round
+std::vector<Bus*> TemperatureEngine::ConvertRound(std::vector<Bus*>* buses){
+
+	std::vector<Bus*> postponed;
+	std::vector<Bus*> powered;
+	std::set<Master*> poweredMasters;
+	unsigned int firstDevice = devices.size();
+
+	conversions.clear();
+
+	//1. convert, strong pullups last on their master
+	for (unsigned int i=0; i < buses->size(); i++){
+		Bus* bus = buses->at(i);
+		std::vector<Device*> sensors = GetSensors(bus, true);
+
+		if (!NeedsStrongPullup(bus, &sensors))
+			Convert(bus, &sensors, false);
+
+		else if (poweredMasters.count(bus->GetMaster()))
+			postponed.push_back(bus);
+
+		else {
+			poweredMasters.insert(bus->GetMaster());
+			powered.push_back(bus);
+		}
+	}
+
+	for (unsigned int i=0; i < powered.size(); i++){
+		std::vector<Device*> sensors = GetSensors(powered[i], true);
+		Convert(powered[i], &sensors, true);
+	}
+
+	//2. wait, buses converted first are checked first. A read slot
+	//would end the strong pullup on the same master.
+	for (unsigned int i=0; i < conversions.size(); i++){
+		if (poweredMasters.count(conversions[i].bus->GetMaster()))
+			conversions[i].pollable = false;
+
+		WaitForConversion(&conversions[i]);
+	}
+
+	//3. read
+	ReadFrom(firstDevice);
+
+	return postponed;
+}
+
+
+//Filtered by the resolutions, if selected
+std::vector<Device*> TemperatureEngine::GetSensors(Bus* bus, bool selected){
+
+	std::vector<Device*> sensors;
+	std::vector<Device*> busDevices = deviceStore->GetBusDevices(bus);
+
+	for (unsigned int i=0; i < busDevices.size(); i++){
+		if (busDevices[i]->IsReady() && busDevices[i]->GetConversionTime() > 0 && (!selected || IsSelected(busDevices[i])))
+			sensors.push_back(busDevices[i]);
+	}
+
+	return sensors;
+}
+
+
+bool TemperatureEngine::IsSelected(Device* sensor){
+	return resolutions.empty() || std::find(resolutions.begin(), resolutions.end(), sensor->GetResolution()) != resolutions.end();
+}
+
+
+bool TemperatureEngine::NeedsStrongPullup(Bus* bus, std::vector<Device*>* sensors){
+
+	for (unsigned int i=0; bus->HasStrongPullup() && i < sensors->size(); i++){
+		if (sensors->at(i)->IsParasitePowered())
+			return true;
+	}
+
+	return false;
+}
+
+
+//Each bus is ready after the conversion time of its slowest converting
+//sensor. The strong pullup ends with the next command, so powered buses
+//are always broadcast and wait for all sensors on the bus. When only the
+//selected sensors are addressed, a read slot reaches the last of them
+//only, these buses wait the conversion time as well.
+void TemperatureEngine::Convert(Bus* bus, std::vector<Device*>* sensors, bool powered){
+
+	Conversion conversion = { bus, true, std::chrono::steady_clock::time_point() };
+	std::vector<Device*> busSensors = GetSensors(bus, false);
+	std::vector<Device*>* converting = powered ? &busSensors : sensors;
+	int conversionTime = 0;
+
+	for (unsigned int i=0; i < converting->size(); i++){
+		if (converting->at(i)->GetConversionTime() > conversionTime)
+			conversionTime = converting->at(i)->GetConversionTime();
+
+		if (converting->at(i)->IsParasitePowered())
+			conversion.pollable = false;
+	}
+
+	bus->SetOverdriveSpeed(false);
+
+	if (powered)
+		bus->BroadcastPowerCommand(CMD_TCONV);
+
+	else if (sensors->size() == busSensors.size())
+		bus->BroadcastCommand(CMD_TCONV);
+
+	else {
+		for (unsigned int i=0; i < sensors->size(); i++)
+			sensors->at(i)->Command(CMD_TCONV);
+
+		conversion.pollable = false;
+	}
+
+	conversion.readyAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(conversionTime);
+	conversions.push_back(conversion);
+
+	devices.insert(devices.end(), sensors->begin(), sensors->end());
+}
+
+
+//Converting sensors answer read slots with 0. The maximum conversion
+//time is the limit, parasite powered buses just wait for it.
+void TemperatureEngine::WaitForConversion(Conversion* conversion){
+
+	while (conversion->pollable && std::chrono::steady_clock::now() < conversion->readyAt){
+		if (conversion->bus->ReadBit())
+			return;
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(POLL_INTERVAL_MS));
+	}
+
+	std::this_thread::sleep_until(conversion->readyAt);
+}
+
+
+void TemperatureEngine::ReadFrom(unsigned int firstDevice){
+	for (unsigned int i=firstDevice; i < devices.size(); i++)
+		verified.push_back(devices[i]->ReadAndVerify(DDT_VALUES));
+}
@@ -0,0 +1,67 @@
+#ifndef TEMPERATURE_ENGINE_H
+#define TEMPERATURE_ENGINE_H
+
+#include "device_store.h"
+#include "../device/device.h"
+#include "../master/bus/bus.h"
+#include <vector>
+#include <map>
+#include <chrono>
+
+
+// Bus with a running conversion
+typedef struct {
+	Bus* bus;
+	bool pollable;
+	std::chrono::steady_clock::time_point readyAt;
+} Conversion;
+
+
+// Sensors with the same resolution, ready after the slowest of them
+typedef struct {
+	int conversionTime;
+	std::vector<Device*> devices;
+} TemperatureGroup;
+
+
+// Temperature snapshot over many buses: the convert command is sent to
+// every bus back-to-back, then it waits once for the slowest sensor and
+// reads all scratchpads in bus order. Buses without parasite powered
+// sensors are polled with read slots instead of waiting the maximum
+// conversion time.
+// Parasite powered buses convert with the strong pullup, which holds the
+// whole master until its next 1wire command. These are converted last
+// and only one per master, further ones follow in the next round.
+// With resolutions set only these sensors are converted and read, so a
+// group of fast sensors is not held by the slow ones on its bus, unless
+// the bus needs the strong pullup.
+class TemperatureEngine {
+
+  public:
+	TemperatureEngine(DeviceStore*);
+
+	void SetResolutions(std::vector<int>*);
+	void ConvertAndRead(std::vector<Bus*>*);
+	std::map<int, TemperatureGroup> GetGroups(std::vector<Bus*>*);
+	std::vector<Device*>* GetDevices(void);
+	std::vector<bool>* GetVerified(void);
+
+
+  private:
+	std::vector<Bus*> ConvertRound(std::vector<Bus*>*);
+	std::vector<Device*> GetSensors(Bus*, bool);
+	bool IsSelected(Device*);
+	bool NeedsStrongPullup(Bus*, std::vector<Device*>*);
+	void Convert(Bus*, std::vector<Device*>*, bool);
+	void WaitForConversion(Conversion*);
+	void ReadFrom(unsigned int);
+
+	DeviceStore* deviceStore;
+	std::vector<int> resolutions;
+	std::vector<Device*> devices;
+	std::vector<bool> verified;
+	std::vector<Conversion> conversions;
+};
+
+
+#endif
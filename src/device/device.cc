@@ -15,12 +15,17 @@ using namespace v8;
 
 
 Device::Device(Bus* bus, uint64_t intDeviceId, std::string* strDeviceId)
-    : bus(bus), intId(intDeviceId), strId(*strDeviceId), supported(true), overdriveSpeed(false)
+    : bus(bus), intId(intDeviceId), strId(*strDeviceId), supported(true), overdriveSpeed(false), overdriveCrcFailures(0), probing(false)
 {}
 
 
 void Device::AfterNewSearched(uint64_t currentSyncId){
 	syncId = currentSyncId;
+}
+
+
+//Separated from AfterNewSearched, because it accesses the bus
+void Device::Setup(void){
 	state = supported ? Initialize() ? STATE_READY : STATE_INITIALIZE_FAILED : STATE_UNSUPPORTED;
 }
 
@@ -56,7 +61,7 @@ uint64_t Device::GetSyncId(void){
 
 
 void Device::Command(uint8_t command){
-	GetBus()->DeviceCommand(GetIntId(), command);
+	GetBus()->DeviceCommand(GetIntId(), command, SupportsResume(), overdriveSpeed);
 }
 
 
@@ -76,8 +81,7 @@ void Device::ReadBytes(uint8_t byteCount){
 
 
 void Device::ReadBytes(uint8_t dataStartIdx, uint8_t byteCount){
-	for (int i=0; i<byteCount; i++)
-		ReadByte(i + dataStartIdx);
+	GetBus()->ReadBlock(data + dataStartIdx, byteCount);
 }
 
 
@@ -86,13 +90,23 @@ void Device::WriteByte(uint8_t byte){
 }
 
 
+void Device::WriteBytePowered(uint8_t byte){
+	GetBus()->WriteBytePowered(byte);
+}
+
+
+void Device::WriteBytes(const uint8_t* bytes, uint8_t byteCount){
+	GetBus()->WriteBlock(bytes, byteCount);
+}
+
+
 bool Device::Crc8DataValidate(uint8_t buildByteCount, uint8_t idxCrc8Expected){
-	return Crc::Validate8Bit(data, buildByteCount, data[idxCrc8Expected]);
+	return CountCrcResult(Crc::Validate8Bit(data, buildByteCount, data[idxCrc8Expected]));
 }
 
 
 bool Device::Crc16DataValidate(uint8_t buildByteCount, uint8_t idxByte1Crc16Expected, uint8_t idxByte2Crc16Expected){
-	return Crc::Validate16Bit(data, buildByteCount, data[idxByte1Crc16Expected], data[idxByte2Crc16Expected]);
+	return CountCrcResult(Crc::Validate16Bit(data, buildByteCount, data[idxByte1Crc16Expected], data[idxByte2Crc16Expected]));
 }
 
 
@@ -107,38 +121,64 @@ const char* Device::GetUpdaterValidator(std::string* name){
 
 
 bool Device::ExecuteUpdater(std::string* name, std::string* value){
-
-	//enable overdrive support on updates
-	GetBus()->SetOverdriveSpeed(overdriveSpeed);
-
 	return updaters[*name].callback(value->c_str());
 }
 
 
 bool Device::UpdateOverdriveSpeed(const char* speed){
 	overdriveSpeed = (speed[0] == 'o');
+	overdriveCrcFailures = 0;
 	return true;
 }
 
 
-//Required to sort devices for efficient read
-bool Device::operator < (Device &device){
+//The probe is a read in overdrive: the device is moved to overdrive with
+//Overdrive Match ROM and the data must pass its CRC check. Otherwise the
+//device stays in standard speed. A failed probe is no CRC failure.
+bool Device::DetectOverdrive(void){
+
+	if (!IsReady() || !SupportsOverdrive() || overdriveSpeed)
+		return overdriveSpeed;
+
+	overdriveSpeed = true;
+	probing = true;
+	ReadAllData();
+	overdriveSpeed = VerifyAllData();
+	probing = false;
+	overdriveCrcFailures = 0;
+
+	return overdriveSpeed;
+}
+
+
+bool Device::HasOverdriveSpeed(void){
 	return overdriveSpeed;
 }
 
 
 Handle<Object> Device::ToV8Object(int types, bool addDeviceId){
+	return ToV8Object(types, addDeviceId, ReadAndVerify(types));
+}
 
-	Handle<Object> result = Object::New();
 
-	if (addDeviceId)
-		V8Helper::AddPairToV8Object(result, "id", GetStrId());
+//Hardware part of ToV8Object, does not touch V8 and may run on a worker thread
+bool Device::ReadAndVerify(int types){
 
 	//1. read
 	ToV8ObjectReadData(types);
 
 	//2. verify
-	bool verified = ToV8ObjectVerifyData(types);
+	return ToV8ObjectVerifyData(types);
+}
+
+
+//V8 part of ToV8Object, builds the result from the last ReadAndVerify
+Handle<Object> Device::ToV8Object(int types, bool addDeviceId, bool verified){
+
+	Handle<Object> result = Object::New();
+
+	if (addDeviceId)
+		V8Helper::AddPairToV8Object(result, "id", GetStrId());
 
 	//3. build
 	if (verified)
@@ -154,6 +194,30 @@ Handle<Object> Device::ToV8Object(int types, bool addDeviceId){
 
 //protected
 
+//CRC failures are counted per bus. A new device answering a Skip ROM
+//garbles the data, so the bus uses Match ROM until the next sync. A
+//device may also have lost its selection for Resume. Repeated failures
+//in overdrive bring the device back to standard speed.
+bool Device::CountCrcResult(bool valid){
+
+	if (probing)
+		return valid;
+
+	if (!valid){
+		GetBus()->GetStatistics()->crcFailures++;
+		GetBus()->SetSoleDeviceId(0);
+		GetBus()->ClearResumeDeviceId();
+	}
+
+	if (overdriveSpeed){
+		overdriveCrcFailures = valid ? 0 : overdriveCrcFailures + 1;
+		overdriveSpeed = (overdriveCrcFailures < OVERDRIVE_MAX_CRC_FAILURES);
+	}
+
+	return valid;
+}
+
+
 void Device::SetUnsupported(void){
 	supported = false;
 }
@@ -174,11 +238,11 @@ void Device::RegisterOverdriveUpdater(void){
 
 void Device::ToV8ObjectReadData(int types){
 
-	//enable overdrive support on read
-	GetBus()->SetOverdriveSpeed(overdriveSpeed);
+	//connection data is built without bus access
+	if (!Util::BitIsMasked(types, DDT_PROPERTIES) && !Util::BitIsMasked(types, DDT_VALUES))
+		return;
 
-	if (Util::BitIsMasked(types, DDT_PROPERTIES) || Util::BitIsMasked(types, DDT_VALUES))
-		ReadAllData();
+	ReadAllData();
 
 	if (Util::BitIsMasked(types, DDT_PROPERTIES))
 		ReadPropertyData();
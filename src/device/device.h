@@ -17,6 +17,9 @@
 #define DDT_PROPERTIES	2
 #define DDT_VALUES		4
 
+//Consecutive CRC failures in overdrive before falling back to standard speed
+#define OVERDRIVE_MAX_CRC_FAILURES 3
+
 //Shortcut for RegisterUpdater function
 #define REGISTER_UPDATER(fn, name, vld) RegisterUpdater(std::bind(&fn, this, std::placeholders::_1), name, vld)
 
@@ -49,12 +52,24 @@ class Device {
 	virtual bool VerifyValueData(void)	  {return true;}
 	virtual bool VerifyAllData(void)	  {return true;}
 
+	//Temperature sensors, for overwrite. Conversion time in ms.
+	virtual int  GetConversionTime(void){return 0;}
+	virtual int  GetResolution(void){return 0;}
+	virtual bool IsParasitePowered(void){return false;}
+
+	//Devices which keep their selection for a Resume ROM command
+	virtual bool SupportsResume(void){return false;}
+
+	//Devices which can be probed for overdrive on sync
+	virtual bool SupportsOverdrive(void){return false;}
+
 	//Build functions, for overwrite
 	virtual void BuildPropertyData(Handle<Object>){}
 	virtual void BuildValueData(Handle<Object>){}
 	virtual void BuildConnectionData(Handle<Object>);
 
 	void AfterNewSearched(uint64_t);
+	void Setup(void);
 	void AfterAgainSearched(uint64_t);
 	bool IsReady(void);
 
@@ -69,6 +84,8 @@ class Device {
 	void ReadBytes(uint8_t);
 	void ReadBytes(uint8_t, uint8_t);
 	void WriteByte(uint8_t);
+	void WriteBytePowered(uint8_t);
+	void WriteBytes(const uint8_t*, uint8_t);
 
 	bool Crc8DataValidate(uint8_t, uint8_t);
 	bool Crc16DataValidate(uint8_t, uint8_t, uint8_t);
@@ -78,11 +95,15 @@ class Device {
 	const char* GetUpdaterValidator(std::string*);
 
 	bool UpdateOverdriveSpeed(const char*);
-	bool operator < (Device&);
+	bool DetectOverdrive(void);
+	bool HasOverdriveSpeed(void);
+	bool ReadAndVerify(int);
 	Handle<Object> ToV8Object(int, bool);
+	Handle<Object> ToV8Object(int, bool, bool);
 
 
   protected:
+	bool CountCrcResult(bool);
 	void SetUnsupported(void);
 	void RegisterUpdater(std::function<bool(const char*)>, const char*, const char*);
 	void RegisterOverdriveUpdater(void);
@@ -105,6 +126,8 @@ class Device {
 
 	bool supported;
 	bool overdriveSpeed;
+	int  overdriveCrcFailures;
+	bool probing;
 
 	std::map<std::string, Updater> updaters;
 
@@ -2,8 +2,11 @@
 #include "lib/temp.h"
 #include "../master/bus/bus.h"
 #include "../shared/v8_helper.h"
+#include "../shared/match.h"
 #include <stdint.h>
 #include <string>
+#include <stdlib.h>
+#include <chrono>
 
 //COMMANDS
 #define CMD_SCRATCHPAD_READ    0xBE
@@ -13,6 +16,8 @@
 //DATA-BYTES
 #define DIX_TEMP_LSB		   0
 #define DIX_TEMP_MSB		   1
+#define DIX_ALARM_HIGH		   2
+#define DIX_ALARM_LOW		   3
 #define DIX_CONFIG_REGISTER    4
 #define DIX_CRC8			   8
 #define DIX_POWER_SUPPLY	   9
@@ -21,22 +26,57 @@
 #define PPC_RESOLUTION   	   0
 #define INIT_RESOLUTION  	   "12bit"
 
+//ALARM, the initial thresholds are out of range, no alarm is raised
+#define PPC_ALARM_HIGH		   1
+#define PPC_ALARM_LOW		   2
+#define INIT_ALARM_HIGH		   0x7F		//+127 C
+#define INIT_ALARM_LOW		   0x80		//-128 C
+
+//PLAUSIBILITY of fast reads, raw values in 1/16 C
+#define RAW_POWER_ON		   0x0550	//85.0 C
+#define RAW_NO_RESPONSE		   -1		//line stays high
+#define RAW_MIN				   (-55 * 16)
+#define RAW_MAX				   (125 * 16)
+#define RAW_MAX_STEP		   (1 * 16)	//per read
+#define RAW_MAX_RATE		   (5 * 16)	//per second
+
 using namespace v8;
 
 
-Ds18b20::Ds18b20(Bus* bus, uint64_t intDeviceId, std::string* strDeviceId) : Device(bus, intDeviceId, strDeviceId){
+Ds18b20::Ds18b20(Bus* bus, uint64_t intDeviceId, std::string* strDeviceId) : Device(bus, intDeviceId, strDeviceId), parasitePower(false), fastRead(false), fastReadDone(false), hasLastTemperature(false), lastTemperature(0){
 	REGISTER_UPDATER(Ds18b20::UpdateResolution, "resolution", "9bit|10bit|11bit|12bit");
+	REGISTER_UPDATER(Ds18b20::UpdateReadMode, "readMode", "fast|full");
+	REGISTER_UPDATER(Ds18b20::UpdateAlarmHigh, "alarmHigh", MP_CELSIUS);
+	REGISTER_UPDATER(Ds18b20::UpdateAlarmLow, "alarmLow", MP_CELSIUS);
+
+	propCache[PPC_ALARM_HIGH] = INIT_ALARM_HIGH;
+	propCache[PPC_ALARM_LOW]  = INIT_ALARM_LOW;
 }
 
 
+//The power supply is read once, parasite powered sensors can not
+//signal the end of a conversion with read slots
 bool Ds18b20::Initialize(void){
+	ReadPropertyData();
+	parasitePower = (data[DIX_POWER_SUPPLY] == 0x00);
+
 	return UpdateResolution(INIT_RESOLUTION);
 }
 
 
+//In fast mode only the temperature bytes are read, the reset ends the
+//transfer. The first read is a full one, it is the plausibility reference.
 void Ds18b20::ReadValueData(void){
-    Command(CMD_SCRATCHPAD_READ);
-    ReadBytes(DIX_CRC8+1);
+
+	fastReadDone = fastRead && hasLastTemperature;
+
+	if (fastReadDone){
+		Command(CMD_SCRATCHPAD_READ);
+		ReadBytes(DIX_TEMP_MSB+1);
+		GetBus()->Reset();
+	}
+	else
+		ReadScratchpad();
 }
 
 
@@ -46,8 +86,22 @@ void Ds18b20::ReadPropertyData(void){
 }
 
 
+//Fast reads have no CRC, implausible values are read again in full
 bool Ds18b20::VerifyValueData(void){
-	return Crc8DataValidate(8, DIX_CRC8);
+
+	bool valid = fastReadDone && IsPlausible();
+
+	if (!valid){
+		if (fastReadDone)
+			ReadScratchpad();
+
+		valid = Crc8DataValidate(8, DIX_CRC8);
+	}
+
+	if (valid)
+		KeepLastTemperature();
+
+	return valid;
 }
 
 
@@ -59,23 +113,70 @@ void Ds18b20::BuildValueData(Handle<Object> target){
 void Ds18b20::BuildPropertyData(Handle<Object> target){
 	V8Helper::AddPairToV8Object(target, "resolution",  "%ubit", propCache[PPC_RESOLUTION]);
 	V8Helper::AddPairToV8Object(target, "powerSupply", data[DIX_POWER_SUPPLY] ? true : false);
+	V8Helper::AddPairToV8Object(target, "readMode",    fastRead ? "fast" : "full");
+	V8Helper::AddPairToV8Object(target, "alarmHigh",   (int) (int8_t) propCache[PPC_ALARM_HIGH]);
+	V8Helper::AddPairToV8Object(target, "alarmLow",    (int) (int8_t) propCache[PPC_ALARM_LOW]);
 }
 
 
 bool Ds18b20::UpdateResolution(const char* strResolution){
 
 	uint8_t resolution = Temp::ResolutionFromString(strResolution);
+	bool success = WriteAndVerifyScratchpad(propCache[PPC_ALARM_HIGH], propCache[PPC_ALARM_LOW], BuildConfigRegister(resolution));
 
-	//Set BIT 6,7 (00=9, 01=10, 10=11, 11=12)
-	uint8_t cfgRegValue = ((resolution-9)*32)+31;
-	WriteConfigRegister(cfgRegValue);
-
-	if (VerifyConfigRegister(cfgRegValue)){
+	if (success)
 		propCache[PPC_RESOLUTION] = resolution;
-		return true;
-	}
 
-	return false;
+	return success;
+}
+
+
+//The next read is a full one again, it sets a new reference
+bool Ds18b20::UpdateReadMode(const char* strReadMode){
+	fastRead = (strReadMode[1] == 'a');
+	hasLastTemperature = false;
+	return true;
+}
+
+
+//The sensor is in alarm after a conversion to this or a higher temperature
+bool Ds18b20::UpdateAlarmHigh(const char* strCelsius){
+
+	uint8_t alarmHigh = (uint8_t) (int8_t) atoi(strCelsius);
+	bool success = WriteAndVerifyScratchpad(alarmHigh, propCache[PPC_ALARM_LOW], BuildConfigRegister(propCache[PPC_RESOLUTION]));
+
+	if (success)
+		propCache[PPC_ALARM_HIGH] = alarmHigh;
+
+	return success;
+}
+
+
+//The sensor is in alarm after a conversion to this or a lower temperature
+bool Ds18b20::UpdateAlarmLow(const char* strCelsius){
+
+	uint8_t alarmLow = (uint8_t) (int8_t) atoi(strCelsius);
+	bool success = WriteAndVerifyScratchpad(propCache[PPC_ALARM_HIGH], alarmLow, BuildConfigRegister(propCache[PPC_RESOLUTION]));
+
+	if (success)
+		propCache[PPC_ALARM_LOW] = alarmLow;
+
+	return success;
+}
+
+
+int Ds18b20::GetConversionTime(void){
+	return Temp::ConversionTime(propCache[PPC_RESOLUTION]);
+}
+
+
+int Ds18b20::GetResolution(void){
+	return propCache[PPC_RESOLUTION];
+}
+
+
+bool Ds18b20::IsParasitePowered(void){
+	return parasitePower;
 }
 
 
@@ -107,19 +208,61 @@ void Ds18b20::BuildTCelsius(Handle<Object> target, const char* targetKey){
 }
 
 
-void Ds18b20::WriteConfigRegister(uint8_t value){
+void Ds18b20::ReadScratchpad(void){
+	fastReadDone = false;
+	Command(CMD_SCRATCHPAD_READ);
+	ReadBytes(DIX_CRC8+1);
+}
 
-	Command(CMD_SCRATCHPAD_WRITE);
-	WriteByte(0xFF);  //Th alarm
-	WriteByte(0xFF);  //Tl alarm
-	WriteByte(value); //CONFIG register
+
+//Not the power-on value, in range and not faster than the sensor can follow
+bool Ds18b20::IsPlausible(void){
+
+	int16_t raw = (int16_t) Temp::ConcatMsbLsb(data[DIX_TEMP_MSB], data[DIX_TEMP_LSB]);
+	int64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lastTemperatureAt).count();
+
+	return
+	  raw != RAW_POWER_ON	 &&
+	  raw != RAW_NO_RESPONSE &&
+	  raw >= RAW_MIN && raw <= RAW_MAX &&
+	  abs(raw - lastTemperature) <= RAW_MAX_STEP + (RAW_MAX_RATE * elapsedMs) / 1000;
 }
 
 
-bool Ds18b20::VerifyConfigRegister(uint8_t shouldBe){
+//The power-on value has a valid CRC, but it is no reference
+void Ds18b20::KeepLastTemperature(void){
+	int16_t raw = (int16_t) Temp::ConcatMsbLsb(data[DIX_TEMP_MSB], data[DIX_TEMP_LSB]);
+
+	if (raw == RAW_POWER_ON)
+		return;
+
+	lastTemperature    = raw;
+	lastTemperatureAt  = std::chrono::steady_clock::now();
+	hasLastTemperature = true;
+}
+
+
+//TH, TL and the config register are always written together. They
+//are kept in the scratchpad only, not copied to the EEPROM.
+bool Ds18b20::WriteAndVerifyScratchpad(uint8_t alarmHigh, uint8_t alarmLow, uint8_t configRegister){
+
+	const uint8_t bytes[3] = { alarmHigh, alarmLow, configRegister };
+
+	Command(CMD_SCRATCHPAD_WRITE);
+	WriteBytes(bytes, 3);
+	ReadScratchpad();
+
+	return
+	  Crc8DataValidate(8, DIX_CRC8) 		 &&
+	  data[DIX_ALARM_HIGH] == alarmHigh 	 &&
+	  data[DIX_ALARM_LOW]  == alarmLow  	 &&
+	  data[DIX_CONFIG_REGISTER] == configRegister;
+}
+
 
-	ReadValueData();
-	return VerifyValueData() && data[DIX_CONFIG_REGISTER] == shouldBe;
+//Set BIT 6,7 (00=9, 01=10, 10=11, 11=12)
+uint8_t Ds18b20::BuildConfigRegister(uint8_t resolution){
+	return ((resolution-9)*32)+31;
 }
 
 
@@ -5,6 +5,7 @@
 #include "stdint.h"
 #include "../master/bus/bus.h"
 #include <string>
+#include <chrono>
 
 using namespace v8;
 
@@ -21,12 +22,28 @@ class Ds18b20 : public Device {
 	void BuildValueData(Handle<Object>);
 	void BuildPropertyData(Handle<Object>);
 	bool UpdateResolution(const char*);
+	bool UpdateReadMode(const char*);
+	bool UpdateAlarmHigh(const char*);
+	bool UpdateAlarmLow(const char*);
+	int  GetConversionTime(void);
+	int  GetResolution(void);
+	bool IsParasitePowered(void);
 
 
   private:
 	void BuildTCelsius(Handle<Object>, const char*);
-	void WriteConfigRegister(uint8_t);
-	bool VerifyConfigRegister(uint8_t);
+	void ReadScratchpad(void);
+	bool IsPlausible(void);
+	void KeepLastTemperature(void);
+
+	bool parasitePower;
+	bool fastRead;
+	bool fastReadDone;
+	bool hasLastTemperature;
+	int16_t lastTemperature;
+	std::chrono::steady_clock::time_point lastTemperatureAt;
+	bool WriteAndVerifyScratchpad(uint8_t, uint8_t, uint8_t);
+	uint8_t BuildConfigRegister(uint8_t);
 
 
 };
@@ -24,12 +24,17 @@
 using namespace v8;
 
 
-Ds18s20::Ds18s20(Bus* bus, uint64_t intDeviceId, std::string* strDeviceId) : Device(bus, intDeviceId, strDeviceId){
+Ds18s20::Ds18s20(Bus* bus, uint64_t intDeviceId, std::string* strDeviceId) : Device(bus, intDeviceId, strDeviceId), parasitePower(false){
 	REGISTER_UPDATER(Ds18s20::UpdateResolution, "resolution", "9bit|10bit|11bit|12bit");
 }
 
 
+//The power supply is read once, parasite powered sensors can not
+//signal the end of a conversion with read slots
 bool Ds18s20::Initialize(void){
+	ReadPropertyData();
+	parasitePower = (data[DIX_POWER_SUPPLY] == 0x00);
+
 	return UpdateResolution(INIT_RESOLUTION);
 }
 
@@ -68,6 +73,22 @@ bool Ds18s20::UpdateResolution(const char* strResolution){
 }
 
 
+//The resolution is extended in software, the conversion is always 12bit
+int Ds18s20::GetConversionTime(void){
+	return Temp::ConversionTime(12);
+}
+
+
+int Ds18s20::GetResolution(void){
+	return propCache[PPC_RESOLUTION];
+}
+
+
+bool Ds18s20::IsParasitePowered(void){
+	return parasitePower;
+}
+
+
 //private
 
 void Ds18s20::BuildTCelsius(Handle<Object> target, const char* targetKey){
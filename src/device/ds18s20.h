@@ -21,11 +21,16 @@ class Ds18s20 : public Device {
 	void BuildValueData(Handle<Object>);
 	void BuildPropertyData(Handle<Object>);
 	bool UpdateResolution(const char*);
+	int  GetConversionTime(void);
+	int  GetResolution(void);
+	bool IsParasitePowered(void);
 
 
   private:
 	void BuildTCelsius(Handle<Object>, const char*);
 
+	bool parasitePower;
+
 
 };
 
@@ -144,13 +144,13 @@ Ds1961::UpdateData (const char *value)
 
 /**
  * Called upon reading values from this object.
+ *
+ * Performs the authenticated read; the result is kept for BuildValueData,
+ * which must not access the bus.
  */
 void
-Ds1961::BuildValueData (Handle<Object> target)
+Ds1961::ReadValueData (void)
 {
-    V8Helper::AddPairToV8Object(target, "generated_secret",
-                                "%.*s", sizeof(gen_secret), gen_secret);
-
     if (!auth_secret_set)
         return;
 
@@ -162,16 +162,39 @@ Ds1961::BuildValueData (Handle<Object> target)
             param_auth_challenge[i] = rand();
     }
 
+    auth_ret = ReadAuthWithChallenge(param_auth_addr, param_auth_challenge,
+                                     auth_bytes, auth_rmac);
+}
+
+
+/**
+ * The scratchpad and copy sequences address the device again with Resume.
+ */
+bool
+Ds1961::SupportsResume (void)
+{
+    return true;
+}
+
+
+/**
+ * Called upon building the values read by ReadValueData.
+ */
+void
+Ds1961::BuildValueData (Handle<Object> target)
+{
+    V8Helper::AddPairToV8Object(target, "generated_secret",
+                                "%.*s", sizeof(gen_secret), gen_secret);
+
+    if (!auth_secret_set)
+        return;
+
     uint8_t
-        bytes[32], ///< bytes read
-        rmac[20],  ///< MAC calculated by device
         lmac[20];  ///< locally calculated MAC
-    int ret = ReadAuthWithChallenge(param_auth_addr, param_auth_challenge,
-                                    bytes, rmac);
-    if (0 != ret)
+    if (0 != auth_ret)
     {
         V8Helper::AddPairToV8Object(target, "authenticated",
-                                    "%s #%d", "ERROR",  -1 * ret);
+                                    "%s #%d", "ERROR",  -1 * auth_ret);
         return;
     }
 
@@ -183,26 +206,26 @@ Ds1961::BuildValueData (Handle<Object> target)
     Secret16to8(param_auth_secret, secret);
 
     DPRINT("# auth_secret8: %.*s\n", sizeof(secret), secret);
-    CalcMacReadAuthPage(lmac, param_auth_addr, bytes,
+    CalcMacReadAuthPage(lmac, GetIntId(), param_auth_addr, auth_bytes,
                         secret, param_auth_challenge);
 
     DPRINT("# rmac: ");
-    for (uint8_t i=0; i<sizeof(rmac); i++)
-        DPRINT("%02x ", rmac[i]);
+    for (uint8_t i=0; i<sizeof(auth_rmac); i++)
+        DPRINT("%02x ", auth_rmac[i]);
 
     DPRINT("\n# lmac: ");
     for (uint8_t i=0; i<sizeof(lmac); i++)
         DPRINT("%02x ", lmac[i]);
     DPRINT("\n");
 
-    bool authenticated = (0 == memcmp(lmac, rmac, sizeof(rmac)));
+    bool authenticated = (0 == memcmp(lmac, auth_rmac, sizeof(auth_rmac)));
 
     V8Helper::AddPairToV8Object(target, "authenticated",
                                 "%s", authenticated ? "YES" : "NO");
     V8Helper::AddPairToV8Object(target, "auth_data",
-                                "%.*s", sizeof(bytes), bytes);
+                                "%.*s", sizeof(auth_bytes), auth_bytes);
     V8Helper::AddPairToV8Object(target, "auth_mac",
-                                "%.*s", sizeof(rmac), rmac);
+                                "%.*s", sizeof(auth_rmac), auth_rmac);
 }
 
 
@@ -327,8 +350,7 @@ Ds1961::WriteScratchPad (uint16_t addr, const uint8_t bytes[8])
     memcpy(data + len, bytes, 8);
     len += 8;
 
-    for (uint8_t i = 1; i < len; i++)
-        WriteByte(data[i]);
+    WriteBytes(data + 1, len - 1);
 
     // check CRC
     ReadBytes(len, 2);
@@ -351,8 +373,7 @@ Ds1961::RefreshScratchPad (uint16_t addr, const uint8_t bytes[8])
     memcpy(data + len, bytes, 8);
     len += 8;
 
-    for (uint8_t i = 1; i < len; i++)
-        WriteByte(data[i]);
+    WriteBytes(data + 1, len - 1);
 
     // check CRC
     ReadBytes(len, 2);
@@ -402,15 +423,15 @@ Ds1961::CopyScratchPad (uint16_t addr, uint8_t es, const uint8_t mac[20])
     data[len++] = (addr >> 8) & 0xFF;    // 2 byte target address
     data[len++] = es;                    // es
 
-    for (uint8_t i = 1; i < len; i++)
-        WriteByte(data[i]);
+    WriteBytes(data + 1, len - 2);
+    WriteBytePowered(es);
 
     // keep powered and wait while MAC is calculated
     nanosleep(&T_CSHA, NULL);
 
-    // send MAC
-    for (uint8_t i = 0; i < 20; i++)
-        WriteByte(mac[i]);
+    // send MAC, keep powered while it is copied
+    WriteBytes(mac, 19);
+    WriteBytePowered(mac[19]);
 
     nanosleep(&T_PROG, NULL);
 
@@ -432,8 +453,7 @@ Ds1961::ReadAuthPage (uint16_t addr, uint8_t bytes[32], uint8_t mac[20])
     data[len++] = (addr >> 0) & 0xFF;
     data[len++] = (addr >> 8) & 0xFF;
 
-    for (uint8_t i = 1; i < len; i++)
-        WriteByte(data[i]);
+    WriteBytes(data + 1, len - 1);
 
     // read data part + 0xFF
     ReadBytes(len, 33);
@@ -477,7 +497,7 @@ Ds1961::LoadFirstSecret (uint16_t addr, uint8_t es)
     WriteByte((addr >> 8) & 0xFF);    // 2 byte target address
 
     // write auth code
-    WriteByte(es);
+    WriteBytePowered(es);
 
     // keep powered and wait while secret is written
     nanosleep(&T_PROG, NULL);
@@ -511,21 +531,21 @@ Ds1961::ReadMemory (int addr, int len, uint8_t bytes[])
 /**
  * Calculate MAC for the Read Authenticated Page operation.
  *
- * @param mac  Resulting MAC is written here.
- * @param addr Address of data.
- * @param pp   Data.
- * @param ss   Secret.
- * @param ch   Challenge.
+ * @param mac   Resulting MAC is written here.
+ * @param intid ROM id of the device.
+ * @param addr  Address of data.
+ * @param pp    Data.
+ * @param ss    Secret.
+ * @param ch    Challenge.
  *
  */
 void
-Ds1961::CalcMacReadAuthPage (uint8_t mac[20], uint16_t addr, uint8_t pp[32],
-                             uint8_t ss[8], uint8_t ch[3])
+Ds1961::CalcMacReadAuthPage (uint8_t mac[20], uint64_t intid, uint16_t addr,
+                             uint8_t pp[32], uint8_t ss[8], uint8_t ch[3])
 {
     uint32_t in[16];
     uint32_t hash[16];
     uint8_t id[7];
-    uint64_t intid = GetIntId();
     int i;
 
     for (i = 0; i < 7; i++)
@@ -553,9 +573,9 @@ bool
 Ds1961::InvCrc16DataValidate (uint8_t buildByteCount,
                               uint8_t idxByte1Crc16Expected,
                               uint8_t idxByte2Crc16Expected){
-    return Crc::Validate16Bit(data, buildByteCount,
-                              ~data[idxByte1Crc16Expected],
-                              ~data[idxByte2Crc16Expected]);
+    return CountCrcResult(Crc::Validate16Bit(data, buildByteCount,
+                                             ~data[idxByte1Crc16Expected],
+                                             ~data[idxByte2Crc16Expected]));
 }
 
 
@@ -37,9 +37,19 @@ class Ds1961 : public Device {
         bool
         UpdateData (const char *value);
 
+        void
+        ReadValueData (void);
+
         void
         BuildValueData (Handle<Object> target);
-        
+
+        bool
+        SupportsResume (void);
+
+        static void
+        CalcMacReadAuthPage (uint8_t mac[20], uint64_t intid, uint16_t addr,
+                             uint8_t pp[32], uint8_t ss[8], uint8_t ch[3]);
+
  private:
         int
         ReadAuthWithChallenge (uint16_t addr, const uint8_t challenge[3],
@@ -75,10 +85,6 @@ class Ds1961 : public Device {
         bool
         ReadMemory (int addr, int len, uint8_t bytes[]);
 
-        void
-        CalcMacReadAuthPage (uint8_t mac[20], uint16_t addr, uint8_t pp[32],
-                             uint8_t ss[8], uint8_t ch[3]);
-
         bool
         InvCrc16DataValidate (uint8_t buildByteCount,
                               uint8_t idxByte1Crc16Expected,
@@ -94,6 +100,12 @@ class Ds1961 : public Device {
             param_auth_challenge[3] = {0},
             param_data_mac[20] = {0};
         uint16_t param_auth_addr = 0, param_data_addr = 0;
+
+        // result of the last authenticated read
+        int auth_ret = 0;
+        uint8_t
+            auth_bytes[32] = {0},
+            auth_rmac[20] = {0};
 };
 
 #endif
@@ -85,6 +85,17 @@ bool Ds2408::VerifyAllData(void){
 }
 
 
+//Multi step updates address the device again with Resume
+bool Ds2408::SupportsResume(void){
+	return true;
+}
+
+
+bool Ds2408::SupportsOverdrive(void){
+	return true;
+}
+
+
 void Ds2408::BuildValueData(Handle<Object> target){
 	BuildValue(target, PIO_INPUT_KEY,    DIX_PIO_INPUT);
 	BuildValue(target, PIO_OUTPUT_KEY,   DIX_PIO_OUTPUT);
@@ -16,6 +16,8 @@ class Ds2408 : public Device {
 
 	void ReadAllData(void);
 	bool VerifyAllData(void);
+	bool SupportsResume(void);
+	bool SupportsOverdrive(void);
 	void BuildValueData(Handle<Object>);
 	void BuildPropertyData(Handle<Object>);
 	bool UpdateRstzPinMode(const char*);
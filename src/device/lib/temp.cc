@@ -1,6 +1,9 @@
 #include "temp.h"
 #include <stdint.h>
 
+//Max. conversion time in ms for 9, 10, 11 and 12 bit
+static const int CONVERSION_TIMES[4] = { 94, 188, 375, 750 };
+
 
 typedef struct {
   const char* r9bit;
@@ -78,3 +81,9 @@ uint8_t Temp::ResolutionFromString(const char* resolution){
 	//extract number from 9bit, 10bit, 11bit, 12bit
 	return resolution[0] == '9' ? 9 : resolution[1]-38;
 }
+
+
+//Resolution 9..12 in bit
+int Temp::ConversionTime(uint8_t resolution){
+	return CONVERSION_TIMES[resolution-9];
+}
@@ -10,6 +10,7 @@ class Temp {
 	static void  	  	HandleSubzero(uint16_t*, uint8_t*);
 	static const char*  DecimalsToString(uint8_t, uint8_t);
 	static uint8_t 	  	ResolutionFromString(const char*);
+	static int 	  		ConversionTime(uint8_t);
 
 };
 
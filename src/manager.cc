@@ -1,12 +1,16 @@
 #include "manager.h"
 #include "controller/controller.h"
 #include "api/broadcast.h"
+#include "api/find.h"
+#include "api/get.h"
 #include "api/read.h"
 #include "api/register.h"
 #include "api/sync.h"
+#include "api/temperature.h"
 #include "api/update.h"
 
 #include <string>
+#include <chrono>
 
 using namespace v8;
 
@@ -20,13 +24,48 @@ void Manager::Init(Handle<Object> target) {
 
   // Supported functions
   AddPrototype(tpl, "broadcastBusCommand", 	Broadcast::BusCommand);
+  AddPrototype(tpl, "convertAndReadTemperatures", Temperature::ConvertAndRead);
+  AddPrototype(tpl, "findAllDevices",	 	Find::AllDevices);
+  AddPrototype(tpl, "findBusDevices",	 	Find::BusDevices);
+  AddPrototype(tpl, "getLatencies",	 	Get::Latencies);
+  AddPrototype(tpl, "getStatistics",	 	Get::Statistics);
+  AddPrototype(tpl, "getTemperatureGroups",	Temperature::Groups);
+  AddPrototype(tpl, "planReadDevicesById",	Read::PlanDevicesById);
+  AddPrototype(tpl, "prepareReadGroup",	Read::PrepareGroup);
   AddPrototype(tpl, "readDevicesById",	 	Read::DevicesById);
+  AddPrototype(tpl, "readGroup",	 		Read::Group);
   AddPrototype(tpl, "registerDS2482Master", Register::DS2482Master);
+  AddPrototype(tpl, "registerEmulatedDS2482Master", Register::EmulatedDS2482Master);
+  AddPrototype(tpl, "registerSimulatedMaster", Register::SimulatedMaster);
+  AddPrototype(tpl, "releaseReadGroup",	 	Read::ReleaseGroup);
   AddPrototype(tpl, "syncAllDevices", 		Sync::AllDevices);
   AddPrototype(tpl, "syncMasterDevices", 	Sync::MasterDevices);
   AddPrototype(tpl, "syncBusDevices",	 	Sync::BusDevices);
+  AddPrototype(tpl, "updateBusConfig",	 	Update::BusConfig);
   AddPrototype(tpl, "updateDeviceById",	 	Update::DeviceById);
 
+  // Asynchronous variants, the last argument is a callback(err, result)
+  AddPrototype(tpl, "broadcastBusCommandAsync", 	Broadcast::BusCommandAsync);
+  AddPrototype(tpl, "convertAndReadTemperaturesAsync", Temperature::ConvertAndReadAsync);
+  AddPrototype(tpl, "findAllDevicesAsync",	 	Find::AllDevicesAsync);
+  AddPrototype(tpl, "findBusDevicesAsync",	 	Find::BusDevicesAsync);
+  AddPrototype(tpl, "getLatenciesAsync",	 	Get::LatenciesAsync);
+  AddPrototype(tpl, "getStatisticsAsync",	 	Get::StatisticsAsync);
+  AddPrototype(tpl, "getTemperatureGroupsAsync",	Temperature::GroupsAsync);
+  AddPrototype(tpl, "planReadDevicesByIdAsync",	Read::PlanDevicesByIdAsync);
+  AddPrototype(tpl, "prepareReadGroupAsync",	Read::PrepareGroupAsync);
+  AddPrototype(tpl, "readDevicesByIdAsync",	 	Read::DevicesByIdAsync);
+  AddPrototype(tpl, "readGroupAsync",	 		Read::GroupAsync);
+  AddPrototype(tpl, "registerDS2482MasterAsync", 	Register::DS2482MasterAsync);
+  AddPrototype(tpl, "registerEmulatedDS2482MasterAsync", Register::EmulatedDS2482MasterAsync);
+  AddPrototype(tpl, "registerSimulatedMasterAsync", Register::SimulatedMasterAsync);
+  AddPrototype(tpl, "releaseReadGroupAsync",	 	Read::ReleaseGroupAsync);
+  AddPrototype(tpl, "syncAllDevicesAsync", 		Sync::AllDevicesAsync);
+  AddPrototype(tpl, "syncMasterDevicesAsync", 		Sync::MasterDevicesAsync);
+  AddPrototype(tpl, "syncBusDevicesAsync",	 	Sync::BusDevicesAsync);
+  AddPrototype(tpl, "updateBusConfigAsync",	 	Update::BusConfigAsync);
+  AddPrototype(tpl, "updateDeviceByIdAsync",	 	Update::DeviceByIdAsync);
+
   Persistent<Function> constructor = Persistent<Function>::New(tpl->GetFunction());
   target->Set(String::NewSymbol("Manager"), constructor);
 }
@@ -36,12 +75,35 @@ void Manager::Init(Handle<Object> target) {
 Handle<Value> Manager::New(const Arguments& args) {
   Manager* manager = new Manager();
   manager->controller = new Controller();
+  manager->asyncRunning = false;
+  manager->callLatencies = NULL;
   manager->Wrap(args.This());
 
   return args.This();
 }
 
 
+//Times every API call, async calls are timed until their callback by Async
+Handle<Value> Manager::Call(const Arguments& args) {
+  ApiFunction* api = static_cast<ApiFunction*>(External::Unwrap(args.Data()));
+  Manager* manager = node::ObjectWrap::Unwrap<Manager>(args.This());
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  manager->callLatencies = &manager->apiLatencies[api->name];
+  Handle<Value> result = api->fn(args);
+
+  if (manager->callLatencies != NULL)
+	  manager->callLatencies->Add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+
+  manager->callLatencies = NULL;
+  return result;
+}
+
+
 void Manager::AddPrototype(Handle<FunctionTemplate> tpl, const char* fnName, Handle<Value> (*fn)(const Arguments&)){
-	tpl->PrototypeTemplate()->Set(String::NewSymbol(fnName), FunctionTemplate::New(fn)->GetFunction());
+	ApiFunction* api = new ApiFunction();
+	api->name = fnName;
+	api->fn   = fn;
+
+	tpl->PrototypeTemplate()->Set(String::NewSymbol(fnName), FunctionTemplate::New(Call, External::New(api))->GetFunction());
 }
@@ -3,6 +3,17 @@
 
 #include <node.h>
 #include "controller/controller.h"
+#include "shared/histogram.h"
+#include <deque>
+#include <map>
+#include <string>
+
+class AsyncJob;
+
+typedef struct {
+  const char* name;
+  v8::Handle<v8::Value>(*fn)(const v8::Arguments&);
+} ApiFunction;
 
 
 class Manager : public node::ObjectWrap {
@@ -10,8 +21,16 @@ class Manager : public node::ObjectWrap {
   static void Init(v8::Handle<v8::Object>);
   Controller *controller;
 
+  std::deque<AsyncJob*> asyncJobs;
+  bool asyncRunning;
+
+  //Latencies per API function, async calls are taken over by their job
+  std::map<std::string, Histogram> apiLatencies;
+  Histogram* callLatencies;
+
  private:
   static v8::Handle<v8::Value> New(const v8::Arguments&);
+  static v8::Handle<v8::Value> Call(const v8::Arguments&);
   static void AddPrototype(v8::Handle<v8::FunctionTemplate>, const char*, v8::Handle<v8::Value>(*fn)(const v8::Arguments&));
 };
 
@@ -1,6 +1,7 @@
 #include "bus.h"
 #include "search.h"
 #include "../ds2482.h"
+#include "../statistics.h"
 #include <stdint.h>
 #include <vector>
 
@@ -9,13 +10,20 @@
 #define W1_MATCH_ROM_OVERDRIVE    0x69
 #define W1_SKIP_ROM     		  0xCC
 #define W1_SKIP_ROM_OVERDRIVE     0x3C
+#define W1_RESUME     		  	  0xA5
 
 
 Bus::Bus(Master* master, int number)
-	: master(master), number(number), overdriveSpeed(false)
+	: master(master), number(number), overdriveSpeed(false), activePullup(false), strongPullup(true), soleDeviceId(0), resumeDeviceId(0), search(NULL), searchContinued(false)
 {}
 
 
+//A search stopped by maxDevices may still be pending
+Bus::~Bus(void){
+	delete search;
+}
+
+
 Master* Bus::GetMaster(void){
 	return master;
 }
@@ -26,74 +34,295 @@ int Bus::GetNumber(void){
 }
 
 
+//Always starts a new search for all remaining devices
 std::vector<uint64_t> Bus::SearchDeviceIds(bool alarmOnly){
-	Search *search = new Search(this);
-	std::vector<uint64_t> deviceIds = search->Execute(alarmOnly);
 	delete search;
+	search = NULL;
+
+	return SearchDeviceIds(alarmOnly, 0);
+}
+
+
+//Continues the pending search of the same kind, otherwise a new one is
+//started. It stops after maxDevices found devices, 0 finds all.
+std::vector<uint64_t> Bus::SearchDeviceIds(bool alarmOnly, int maxDevices){
+	searchContinued = (search != NULL && search->IsAlarmOnly() == alarmOnly);
+
+	if (!searchContinued){
+		delete search;
+		search = new Search(this, alarmOnly);
+	}
+
+	resumeDeviceId = 0;
+	std::vector<uint64_t> deviceIds = search->Execute(maxDevices);
+
+	if (search->IsFinished()){
+		delete search;
+		search = NULL;
+	}
 
 	return deviceIds;
 }
 
 
-void Bus::DeviceCommand(uint64_t deviceId, uint8_t command){
-	
-	Reset();
-	WriteByte(W1_MATCH_ROM);
+//True while a search stopped by maxDevices has not found all devices
+bool Bus::IsSearchPending(void){
+	return search != NULL;
+}
 
-	for (uint8_t i = 0; i < 8; i++)
-	  WriteByte((uint8_t) (deviceId >> i*8));
 
-	WriteByte(command);
+//True if the last search call continued a pending search
+bool Bus::IsSearchContinued(void){
+	return searchContinued;
+}
+
+
+//Searches one family code or SEARCH_ALL_FAMILIES, optionally only the
+//devices in alarm. A pending search of a sync is not affected.
+std::vector<uint64_t> Bus::FindDeviceIds(int familyCode, bool alarmOnly){
+	Search find(this, alarmOnly, familyCode);
+	resumeDeviceId = 0;
+
+	return find.Execute(0);
+}
+
+
+//The ROM id is left out, if the device is known to be alone on the bus
+//or if it was addressed last and keeps its selection for Resume.
+//Overdrive devices are moved to overdrive once with Overdrive Match ROM
+//and are then addressed in overdrive until the next standard speed reset.
+//With several overdrive devices one Overdrive Skip ROM moves them all,
+//so addressing them alternately needs no standard speed reset.
+void Bus::DeviceCommand(uint64_t deviceId, uint8_t command, bool resumable, bool overdrive){
+
+	uint8_t bytes[10];
+	int length  = 0;
+	bool sole   = (deviceId == soleDeviceId);
+	bool resume = false;
+
+	if (overdrive)
+		overdriveTargetIds.insert(deviceId);
+	else
+		overdriveTargetIds.erase(deviceId);
+
+	if (overdrive && !InOverdrive(deviceId) && !sole && overdriveTargetIds.size() > 1)
+		SkipToOverdrive();
+
+	if (overdrive && !InOverdrive(deviceId)){
+		SetMasterSpeed(false);
+		Reset();
+		WriteByte(sole ? W1_SKIP_ROM_OVERDRIVE : W1_MATCH_ROM_OVERDRIVE);
+		SetMasterSpeed(true);
+		overdriveDeviceIds.insert(deviceId);
+
+	} else {
+		SetMasterSpeed(overdrive);
+		resume = (deviceId == resumeDeviceId && !sole);
+		Reset();
+		bytes[length++] = sole ? W1_SKIP_ROM : (resume ? W1_RESUME : W1_MATCH_ROM);
+	}
+
+	if (!sole && !resume){
+		for (uint8_t i = 0; i < 8; i++)
+		  bytes[length++] = (uint8_t) (deviceId >> i*8);
+	}
+
+	bytes[length++] = command;
+	resumeDeviceId  = (!sole && resumable) ? deviceId : 0;
+
+	WriteBlock(bytes, length);
 }
 
 
+//Skip ROM deselects the device for Resume, like every other ROM command
 void Bus::BroadcastCommand(uint8_t command){
+	resumeDeviceId = 0;
 	Reset();
 	WriteByte(W1_SKIP_ROM);
 	WriteByte(command);
 }
 
 
+//For commands that draw power after the last byte (convert, copy scratchpad)
+void Bus::BroadcastPowerCommand(uint8_t command){
+	resumeDeviceId = 0;
+	Reset();
+	WriteByte(W1_SKIP_ROM);
+	WriteBytePowered(command);
+}
+
+
+//Used before broadcasts and searches, the next reset in standard speed
+//brings all devices back to standard speed
 void Bus::SetOverdriveSpeed(bool useOverdriveSpeed){
+	SetMasterSpeed(useOverdriveSpeed);
+}
 
-	//1. inform devices about overdrive
-	if (!overdriveSpeed && useOverdriveSpeed){
-	     Reset();
-	     WriteByte(W1_SKIP_ROM_OVERDRIVE);
-	}
 
-	//2. inform master about bus speed
-	master->SetOverdriveSpeed(useOverdriveSpeed);
-	overdriveSpeed = useOverdriveSpeed;
+bool Bus::InOverdrive(uint64_t deviceId){
+	return overdriveDeviceIds.count(deviceId) > 0;
+}
+
+
+//Overdrive Skip ROM selects all devices, the following overdrive
+//speed reset deselects them again before the Match ROM
+void Bus::SkipToOverdrive(void){
+	SetMasterSpeed(false);
+	Reset();
+	WriteByte(W1_SKIP_ROM_OVERDRIVE);
+	SetMasterSpeed(true);
+
+	overdriveDeviceIds.insert(overdriveTargetIds.begin(), overdriveTargetIds.end());
+}
+
+
+//The master config is shared by its buses, it follows the selected bus
+void Bus::SetActivePullup(bool enabled){
+	activePullup = enabled;
+
+	if (master->GetSelectedBus() == this)
+		master->SetActivePullup(enabled);
+}
+
+
+bool Bus::HasActivePullup(void){
+	return activePullup;
 }
 
 
+//Enabled by default, parasite powered devices need it
+void Bus::SetStrongPullup(bool enabled){
+	strongPullup = enabled;
+}
+
+
+bool Bus::HasStrongPullup(void){
+	return strongPullup;
+}
+
+
+//Set after a sync found exactly one device, 0 otherwise
+void Bus::SetSoleDeviceId(uint64_t deviceId){
+	soleDeviceId = deviceId;
+}
+
+
+uint64_t Bus::GetSoleDeviceId(void){
+	return soleDeviceId;
+}
+
+
+void Bus::ClearResumeDeviceId(void){
+	resumeDeviceId = 0;
+}
+
+
+//Without presence pulse the sole device is gone and no device
+//keeps its selection. A reset in standard speed ends overdrive.
 uint8_t Bus::Reset(void){
 	Select();
-	return master->W1Reset();
+	BusyTimer timer(&statistics, master->GetLatencies(PRIM_W1_RESET));
+	statistics.resets++;
+
+	if (overdriveSpeed)
+		statistics.overdriveResets++;
+
+	uint8_t noPresence = master->W1Reset();
+
+	if (!overdriveSpeed)
+		overdriveDeviceIds.clear();
+
+	if (noPresence){
+		soleDeviceId   = 0;
+		resumeDeviceId = 0;
+	}
+
+	return noPresence;
 }
 
 
 void Bus::WriteByte(uint8_t byte){
 	Select();
+	BusyTimer timer(&statistics, master->GetLatencies(PRIM_W1_WRITE_BYTE));
+	statistics.bytesWritten++;
 	master->W1WriteByte(byte);
 }
 
+
+//The line stays powered after the byte until the next 1wire command
+void Bus::WriteBytePowered(uint8_t byte){
+
+	if (strongPullup){
+		Select();
+		statistics.strongPullups++;
+		master->ArmStrongPullup();
+	}
+
+	WriteByte(byte);
+}
+
+
 uint8_t Bus::ReadByte(void){
 	Select();
+	BusyTimer timer(&statistics, master->GetLatencies(PRIM_W1_READ_BYTE));
+	statistics.bytesRead++;
 	return master->W1ReadByte();
 }
 
 
+void Bus::WriteBlock(const uint8_t* bytes, int length){
+	Select();
+	BusyTimer timer(&statistics, master->GetLatencies(PRIM_W1_WRITE_BLOCK));
+	statistics.bytesWritten += length;
+	master->W1WriteBlock(bytes, length);
+}
+
+
+void Bus::ReadBlock(uint8_t* bytes, int length){
+	Select();
+	BusyTimer timer(&statistics, master->GetLatencies(PRIM_W1_READ_BLOCK));
+	statistics.bytesRead += length;
+	master->W1ReadBlock(bytes, length);
+}
+
+
 uint8_t Bus::Triplet(uint8_t bDir){
 	Select();
+	BusyTimer timer(&statistics, master->GetLatencies(PRIM_W1_TRIPLET));
+	statistics.triplets++;
 	return master->W1Triplet(bDir);
 }
 
 
+uint8_t Bus::ReadBit(void){
+	Select();
+	BusyTimer timer(&statistics, master->GetLatencies(PRIM_W1_SINGLE_BIT));
+	return master->W1SingleBit(1);
+}
+
+
+Statistics* Bus::GetStatistics(void){
+	return &statistics;
+}
+
+
+//Devices lose their selection on a speed change. The master is always
+//informed, its config is shared with the other buses.
+void Bus::SetMasterSpeed(bool useOverdriveSpeed){
+
+	if (overdriveSpeed != useOverdriveSpeed)
+		resumeDeviceId = 0;
+
+	master->SetOverdriveSpeed(useOverdriveSpeed);
+	overdriveSpeed = useOverdriveSpeed;
+}
+
+
 void Bus::Select(void){
 	
 	if (master->GetSelectedBus() != this){
+		BusyTimer timer(&statistics, master->GetLatencies(PRIM_SELECT_BUS));
+		master->GetStatistics()->channelSelects++;
 		master->SelectBus(this);
 		master->SetSelectedBus(this);
 	}
@@ -1,38 +1,74 @@
 #ifndef BUS_H
 #define BUS_H
 
+#include "../statistics.h"
 #include <stdint.h>
 #include <vector>
+#include <set>
 
 // "Bus" uses "Master" in header.
 // Redefinition to prevent recursive include
 class Master;
+class Search;
 
 class Bus {
 
   public:
 	Bus(Master*, int);
+	~Bus(void);
 
 	Master* GetMaster();
 	int		GetNumber();
 
 	std::vector<uint64_t>  SearchDeviceIds(bool);
-	void 	DeviceCommand(uint64_t, uint8_t);
+	std::vector<uint64_t>  SearchDeviceIds(bool, int);
+	bool	IsSearchPending(void);
+	bool	IsSearchContinued(void);
+	std::vector<uint64_t>  FindDeviceIds(int, bool);
+	void 	DeviceCommand(uint64_t, uint8_t, bool, bool);
 	void 	BroadcastCommand(uint8_t);
+	void 	BroadcastPowerCommand(uint8_t);
 	void	SetOverdriveSpeed(bool);
+	bool	InOverdrive(uint64_t);
+
+	void	SetActivePullup(bool);
+	bool	HasActivePullup(void);
+	void	SetStrongPullup(bool);
+	bool	HasStrongPullup(void);
+
+	void	 SetSoleDeviceId(uint64_t);
+	uint64_t GetSoleDeviceId(void);
+	void	 ClearResumeDeviceId(void);
 
 	void 	WriteByte(uint8_t);
+	void 	WriteBytePowered(uint8_t);
 	uint8_t ReadByte(void);
+	void	WriteBlock(const uint8_t*, int);
+	void	ReadBlock(uint8_t*, int);
 	uint8_t Triplet(uint8_t);
+	uint8_t ReadBit(void);
 	uint8_t Reset();
 
+	Statistics* GetStatistics(void);
+
 
   private:
 	void 	Select(void);
+	void	SetMasterSpeed(bool);
+	void	SkipToOverdrive(void);
 
 	Master* master;
 	int 	number;
 	bool    overdriveSpeed;
+	bool    activePullup;
+	bool    strongPullup;
+	uint64_t soleDeviceId;
+	uint64_t resumeDeviceId;
+	std::set<uint64_t> overdriveDeviceIds;
+	std::set<uint64_t> overdriveTargetIds;
+	Search*  search;
+	bool     searchContinued;
+	Statistics statistics;
 };
 
 #endif
@@ -1,35 +1,49 @@
 #include "search.h"
 #include "bus.h"
+#include "../../device/lib/crc.h"
 #include <vector>
 #include <stdio.h>
 
-#define MAX_DEVICES 		100
+#define MAX_FAILED_PASSES	3
 #define W1_SEARCH_ALL	 	0xF0
 #define W1_SEARCH_ALARM	 	0xEC
 
 
-Search::Search(Bus* bus)
-	:searchBus(bus)
+Search::Search(Bus* bus, bool alarmOnly)
+	:Search(bus, alarmOnly, SEARCH_ALL_FAMILIES)
+{};
+
+
+//The first pass follows the family code in the lowest byte and takes
+//the 0 path above it, so it finds the first device of the family
+Search::Search(Bus* bus, bool alarmOnly, int familyCode)
+	:searchBus(bus), alarmOnly(alarmOnly), familyCode(familyCode), lastZero(-1), descBit(64), failedPasses(0), isFinished(false),
+	 prevDeviceId(familyCode == SEARCH_ALL_FAMILIES ? 0 : (uint8_t) familyCode)
 {};
 
 
 
-std::vector<uint64_t> Search::Execute(bool searchAlarmOnly){
+//Finds up to maxDevices further devices, 0 finds all remaining ones.
+//A pass without a valid id is repeated, after MAX_FAILED_PASSES in a
+//row the search ends.
+std::vector<uint64_t> Search::Execute(int maxDevices){
 
-	prevDeviceId = 0;
-	deviceCount  = 0;
-	descBit 	 = 64;
-	lastZero 	 = -1;
-	isLastDevice = false;
-	alarmOnly    = searchAlarmOnly;
+	std::vector<uint64_t> deviceIds;
 
-	//in case of 2nd search
-	deviceIds.clear();
+	while (!isFinished && (maxDevices <= 0 || (int) deviceIds.size() < maxDevices)){
 
-	while (NotFinished() && ResetWithDevicesPresent()){
-		deviceId = 0;
-		DiscoverNextDevice();
-		prevDeviceId = deviceId;
+		if (!ResetWithDevicesPresent())
+			isFinished = true;
+		else if (DiscoverNextDevice()){
+			failedPasses = 0;
+
+			if (IsInFamily(prevDeviceId))
+				deviceIds.push_back(prevDeviceId);
+			else
+				isFinished = true;
+
+		} else
+			isFinished = (++failedPasses >= MAX_FAILED_PASSES);
 	}
 
 	return deviceIds;
@@ -37,11 +51,24 @@ std::vector<uint64_t> Search::Execute(bool searchAlarmOnly){
 }
 
 
-void Search::DiscoverNextDevice(void){
+bool Search::IsFinished(void){
+	return isFinished;
+}
+
+
+bool Search::IsAlarmOnly(void){
+	return alarmOnly;
+}
+
+
+//The branch state is only taken over from a complete pass
+bool Search::DiscoverNextDevice(void){
 
 	int searchBit;
+	int zero = lastZero;
 	uint8_t tripletRet;
 	uint64_t tmp64;
+	uint64_t deviceId = 0;
 
 	searchBus->WriteByte(alarmOnly ? W1_SEARCH_ALARM : W1_SEARCH_ALL);
 
@@ -56,20 +83,29 @@ void Search::DiscoverNextDevice(void){
 
 		/* If both directions were valid, and we took the 0 path... */
 		if (tripletRet == 0)
-			lastZero = bit;
+			zero = bit;
 
 		/* Build next part of the deviceId */
 		tmp64 = (tripletRet >> 2);
 		deviceId |= (tmp64 << bit);
 	}
 
+	//a line held low reads as id 0, no device has family code 0x00
+	if (!AnyDeviceResponds(tripletRet) || deviceId == 0)
+		return false;
 
-	if (AnyDeviceResponds(tripletRet)){
-		isLastDevice = (descBit == lastZero) || (lastZero < 0);
-		descBit = lastZero;
-		deviceIds.push_back(deviceId);
+	if (!HasValidCrc(deviceId)){
+		searchBus->GetStatistics()->crcFailures++;
+		return false;
 	}
 
+	isFinished 	 = (descBit == zero) || (zero < 0);
+	descBit 	 = zero;
+	lastZero 	 = zero;
+	prevDeviceId = deviceId;
+
+	return true;
+
 }
 
 
@@ -85,12 +121,23 @@ bool Search::AnyDeviceResponds(uint8_t tripletRet){
 }
 
 
-bool Search::NotFinished(void){
-	return (!isLastDevice && (deviceCount++ < MAX_DEVICES));
+bool Search::ResetWithDevicesPresent(void){
+	return searchBus->Reset() == 0;
 }
 
 
-bool Search::ResetWithDevicesPresent(void){
-	return searchBus->Reset() == 0;
+//Devices of other families are found once the family is done
+bool Search::IsInFamily(uint64_t deviceId){
+	return familyCode == SEARCH_ALL_FAMILIES || (uint8_t) deviceId == familyCode;
 }
 
+
+//The highest byte is the CRC8 of the family code and serial number
+bool Search::HasValidCrc(uint64_t deviceId){
+	uint8_t bytes[8];
+
+	for (uint8_t i = 0; i < 8; i++)
+		bytes[i] = (uint8_t) (deviceId >> i*8);
+
+	return Crc::Validate8Bit(bytes, 7, bytes[7]);
+}
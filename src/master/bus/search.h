@@ -4,32 +4,39 @@
 #include "bus.h"
 #include <stdint.h>
 
+#define SEARCH_ALL_FAMILIES	-1
 
+
+// The branch state is kept between the calls of Execute, so a search
+// can be continued after the last device found. A search for one family
+// code starts in the branch of this family and ends behind it.
 class Search {
 
   public:
-	Search(Bus*);
-	std::vector<uint64_t> Execute(bool);
+	Search(Bus*, bool);
+	Search(Bus*, bool, int);
+	std::vector<uint64_t> Execute(int);
+	bool IsFinished(void);
+	bool IsAlarmOnly(void);
 
 
   private:
-	void DiscoverNextDevice(void);
+	bool DiscoverNextDevice(void);
 	int  DetermineSearchBit(int);
 	bool AnyDeviceResponds(uint8_t);
-	bool NotFinished(void);
 	bool ResetWithDevicesPresent(void);
+	bool IsInFamily(uint64_t);
+	bool HasValidCrc(uint64_t);
 
 	Bus* searchBus;
 	bool alarmOnly;
-	int  deviceCount;
+	int  familyCode;
 	int  lastZero;
-	int  tripletRet;
 	int  descBit;
-	bool isLastDevice;
+	int  failedPasses;
+	bool isFinished;
 
-	uint64_t deviceId;
 	uint64_t prevDeviceId;
-	std::vector<uint64_t> deviceIds;
 
 };
 
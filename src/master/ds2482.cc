@@ -1,18 +1,8 @@
 #include "ds2482.h"
-#include "../shared/util.h"
 #include <string>
 #include <stdio.h>
-
-#ifdef _WIN32
-	#include "lib/i2c-dev-win.h"
-	#include "lib/io-win.h"
-#else
-	#include <fcntl.h>
-	#include <sys/types.h>
-	#include <sys/stat.h>
-	#include <sys/ioctl.h>
-	#include "lib/i2c-dev-linux.h"
-#endif
+#include <chrono>
+#include <thread>
 
 #define CMD_RESET				0xF0
 #define CMD_SET_READ_PTR		0xE1
@@ -25,25 +15,38 @@
 #define CMD_W1_READ_BYTE		0x96
 #define CMD_W1_TRIPLET			0x78
 
+#define REG_STS_SBR				0x20
 #define REG_STS_RST				0x10
 #define REG_STS_LL				0x08
 #define REG_STS_PPD				0x02
 #define REG_STS_1WB				0x01
 #define REG_CFG_1WS				0x08
+#define REG_CFG_SPU				0x04
+#define REG_CFG_APU				0x01
 
 #define PTR_CODE_STATUS			0xF0
 #define PTR_CODE_DATA			0xE1
 #define PTR_CODE_CHANNEL		0xD2
 #define PTR_CODE_CONFIG         0xC3
+#define PTR_CODE_UNKNOWN        0x00
+
+#define CONFIG_UNKNOWN          -1
+#define MAX_STATUS_POLLS		100
 
 
+//Nominal duration of the 1wire commands in us {standard, overdrive}
+static const int durW1Reset[2]		= { 1148, 146 };
+static const int durW1Bit[2]		= {   69,  11 };
+static const int durW1Byte[2]		= {  552,  88 };
+static const int durW1Triplet[2]	= {  207,  33 };
+
 //Bus-Channels for read/write
 static const uint8_t channelsWr[8] = { 0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87 };
 static const uint8_t channelsRd[8] = { 0xB8, 0xB1, 0xAA, 0xA3, 0x9C, 0x95, 0x8E, 0x87 };
 
 
 
-DS2482::DS2482(std::string* name, std::string* subType) : Master(name) {
+DS2482::DS2482(std::string* name, std::string* subType, Transport* transport) : Master(name), transport(transport), overdrive(false), activePullup(false), strongPullup(false), readPtr(PTR_CODE_UNKNOWN), config(CONFIG_UNKNOWN) {
 	int busCount = subType->compare("100") == 0 ? 1 : 8;
 	
 	for(int i=0; i<busCount; i++)
@@ -51,20 +54,22 @@ DS2482::DS2482(std::string* name, std::string* subType) : Master(name) {
 }
 
 
-bool DS2482::Initialize(std::string* devFile, int address){
+DS2482::~DS2482(void){
+	delete transport;
+}
 
-	masterFd = open(devFile->c_str(), O_RDWR);
-	bool success = (masterFd != -1);
-	Util::ThrowExceptionIf(!success, "Cannot open dev file '%s'", devFile->c_str());
 
-	if (success){
-		success = (ioctl(masterFd, I2C_SLAVE, address) != -1);
-		Util::ThrowExceptionIf(!success, "Ioctl failed on '%s', 0x%x", devFile->c_str(), address);
-	}
+bool DS2482::Initialize(std::string* devFile, int address){
+
+	int openResult = transport->Open(devFile, address);
+	bool success = (openResult == OPEN_SUCCESS);
+	SetErrorIf(openResult == OPEN_ERR_DEV_FILE, "Cannot open dev file '%s'", devFile->c_str());
+	SetErrorIf(openResult == OPEN_ERR_ADDRESS, "Ioctl failed on '%s', 0x%x", devFile->c_str(), address);
 
 	if (success){
 		success = SendCmd(CMD_RESET);
-		Util::ThrowExceptionIf(!success, "Master not responding on '%s', 0x%x", devFile->c_str(), address);
+		config  = success ? 0x00 : CONFIG_UNKNOWN;
+		SetErrorIf(!success, "Master not responding on '%s', 0x%x", devFile->c_str(), address);
 	}
 
 	return success;
@@ -72,15 +77,36 @@ bool DS2482::Initialize(std::string* devFile, int address){
 
 
 
+const char* DS2482::GetTransportName(void){
+	return transport->GetName();
+}
+
+
+//The channel may only be switched after the last 1wire command.
+//The active pullup is configured per bus.
 void DS2482::SelectBus(Bus* bus){
+	ReadRegUntilW1Idle();
 	SendCmdWithData(CMD_CHANNEL_SELECT, channelsWr[bus->GetNumber()]);
+	SetActivePullup(bus->HasActivePullup());
 }
 
 
 void DS2482::SetOverdriveSpeed(bool enabled){
-  ReadRegUntilW1Idle();
-  uint8_t regValue = enabled ? REG_CFG_1WS : 0x00;
-  SendCmdWithData(CMD_WRITE_CONFIG, CalculateConfig(regValue));
+  overdrive = enabled;
+  WriteConfig(GetConfigBits());
+}
+
+
+void DS2482::SetActivePullup(bool enabled){
+  activePullup = enabled;
+  WriteConfig(GetConfigBits());
+}
+
+
+//SPU is set right before the byte after which the line is powered
+void DS2482::ArmStrongPullup(void){
+  strongPullup = true;
+  WriteConfig(GetConfigBits());
 }
 
 
@@ -89,17 +115,27 @@ uint8_t DS2482::W1Reset(void){
 
 	ReadRegUntilW1Idle();
 	SendCmd(CMD_W1_RESET);
+	StartW1Command(durW1Reset);
 
 	reg = ReadRegUntilW1Idle();
-	reg = !(reg & REG_STS_PPD);
+	reg = (reg & REG_STS_1WB) || !(reg & REG_STS_PPD);
 
 	return reg;
 }
 
 
+//The chip clears SPU itself when the strong pullup after this byte is
+//ended by the next 1wire command. The cache is cleared at once, a config
+//write without SPU would end the pullup as well.
 void DS2482::W1WriteByte(uint8_t byte){
 	ReadRegUntilW1Idle();
 	SendCmdWithData(CMD_W1_WRITE_BYTE, byte);
+	StartW1Command(durW1Byte);
+
+	if (strongPullup){
+		strongPullup = false;
+		config = (config == CONFIG_UNKNOWN) ? CONFIG_UNKNOWN : GetConfigBits();
+	}
 }
 
 
@@ -107,10 +143,26 @@ uint8_t DS2482::W1ReadByte(void){
 
 	ReadRegUntilW1Idle();
 	SendCmd(CMD_W1_READ_BYTE);
+	StartW1Command(durW1Byte);
+	ReadRegUntilW1Idle();
+
+	return ReadRegister(PTR_CODE_DATA);
+}
+
+
+//After reading the data register of the previous byte the line is
+//still idle, so the wait before the next read command is left out.
+void DS2482::W1ReadBlock(uint8_t* bytes, int length){
+
 	ReadRegUntilW1Idle();
-	SelectRegister(PTR_CODE_DATA);
 
-	return ReadByte();
+	for (int i=0; i<length; i++){
+		SendCmd(CMD_W1_READ_BYTE);
+		StartW1Command(durW1Byte);
+		ReadRegUntilW1Idle();
+		bytes[i] = ReadRegister(PTR_CODE_DATA);
+	}
+
 }
 
 
@@ -118,49 +170,134 @@ uint8_t DS2482::W1Triplet(uint8_t dbit){
 
 	ReadRegUntilW1Idle();
 	SendCmdWithData(CMD_W1_TRIPLET, dbit ? 0xFF : 0);
+	StartW1Command(durW1Triplet);
 	uint8_t status = ReadRegUntilW1Idle();
 
+	//both bits set, as if no device responded
+	if (status & REG_STS_1WB)
+		return 0x03;
+
 	return (status >> 5);
 }
 
 
+//Writes a 0 slot or, with bit 1, a read slot and returns the line level
+uint8_t DS2482::W1SingleBit(uint8_t bit){
+
+	ReadRegUntilW1Idle();
+	SendCmdWithData(CMD_W1_SINGLE_BIT, bit ? 0x80 : 0x00);
+	StartW1Command(durW1Bit);
+	uint8_t status = ReadRegUntilW1Idle();
+
+	return (status & REG_STS_SBR) ? 1 : 0;
+}
+
+
+void DS2482::StartW1Command(const int* duration){
+	w1IdleAt = std::chrono::steady_clock::now() + std::chrono::microseconds(duration[overdrive ? 1 : 0]);
+}
+
+
+//Sleeps for the nominal duration of the running 1wire command, polling
+//the status register before would only keep the I2C bus busy.
+//A failed read returns 0xFF with 1WB set, so the polls are limited. If
+//the master stays busy, 1WB is still set in the returned status.
 uint8_t DS2482::ReadRegUntilW1Idle(void){
 
 	uint8_t reg;
-	SelectRegister(PTR_CODE_STATUS);
+	int polls = 0;
+	std::this_thread::sleep_until(w1IdleAt);
 
-	do {reg = ReadByte();}
-	while ((reg & REG_STS_1WB));
+	do {reg = ReadRegister(PTR_CODE_STATUS); statistics.statusPolls++;}
+	while ((reg & REG_STS_1WB) && ++polls < MAX_STATUS_POLLS);
+
+	SetErrorIf(reg & REG_STS_1WB, "Master '%s' still busy after %d status polls", GetName()->c_str(), MAX_STATUS_POLLS);
+
+	//RST is set after a device reset, the config is back to default then
+	if (reg & REG_STS_1WB)
+		config = CONFIG_UNKNOWN;
+	else if (reg & REG_STS_RST)
+		config = 0x00;
 
 	return reg;
 }
 
 
-uint8_t DS2482::ReadByte(void){
-	return i2c_smbus_read_byte(masterFd);
+//Moving the read pointer and reading is one transfer on plain I2C.
+//After a failed transfer the pointer is set again with the next read.
+uint8_t DS2482::ReadRegister(uint8_t ptrCode){
+
+	uint8_t value = 0xFF;
+	const uint8_t cmd[2] = { CMD_SET_READ_PTR, ptrCode };
+
+	if (readPtr != ptrCode)
+		AfterCmd(CMD_SET_READ_PTR, ptrCode, transport->WriteRead(cmd, 2, &value));
+	else if (!transport->Read(&value))
+		readPtr = PTR_CODE_UNKNOWN;
+
+	return value;
 }
 
 
 
+uint8_t DS2482::GetConfigBits(void){
+	return
+	  (overdrive 	? REG_CFG_1WS : 0x00) |
+	  (strongPullup ? REG_CFG_SPU : 0x00) |
+	  (activePullup ? REG_CFG_APU : 0x00);
+}
+
+
 uint8_t DS2482::CalculateConfig(uint8_t conf){
 	return (conf | ((~conf & 0x0f) << 4));
 }
 
 
-bool DS2482::SelectRegister(uint8_t readPtr){
-	return SendCmdWithData(CMD_SET_READ_PTR, readPtr);
-}
+//Skipped if the value is already in the config register
+bool DS2482::WriteConfig(uint8_t conf){
+
+	if (config == conf)
+		return true;
+
+	ReadRegUntilW1Idle();
+	bool success = SendCmdWithData(CMD_WRITE_CONFIG, CalculateConfig(conf));
+	statistics.configWrites++;
+	config = success ? conf : CONFIG_UNKNOWN;
 
+	return success;
+}
 
 
 bool DS2482::SendCmd(uint8_t cmd){
-	return i2c_smbus_write_byte(masterFd, cmd) == 0;
+	bool success = transport->Write(&cmd, 1);
+	AfterCmd(cmd, 0x00, success);
+
+	return success;
 }
 
 
 
 bool DS2482::SendCmdWithData(uint8_t cmd, uint8_t data){
-	return i2c_smbus_write_byte_data(masterFd, cmd, data) == 0;
+	const uint8_t bytes[2] = { cmd, data };
+	bool success = transport->Write(bytes, 2);
+	AfterCmd(cmd, data, success);
+
+	return success;
+}
+
+
+//Tracks where the DS2482 moves its read pointer after a command
+void DS2482::AfterCmd(uint8_t cmd, uint8_t data, bool success){
+
+	switch (cmd){
+		case CMD_SET_READ_PTR:	 readPtr = data; 			 break;
+		case CMD_CHANNEL_SELECT: readPtr = PTR_CODE_CHANNEL; break;
+		case CMD_WRITE_CONFIG:	 readPtr = PTR_CODE_CONFIG;  break;
+		default:				 readPtr = PTR_CODE_STATUS;  break;
+	}
+
+	if (!success)
+		readPtr = PTR_CODE_UNKNOWN;
 }
 
 
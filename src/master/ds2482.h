@@ -2,33 +2,51 @@
 #define DS2482_H
 
 #include "master.h"
+#include "transport/transport.h"
 #include <string>
+#include <chrono>
 
 
 class DS2482: public Master {
 
   public:
-	DS2482(std::string*, std::string*);
+	DS2482(std::string*, std::string*, Transport*);
+	~DS2482(void);
 	bool Initialize(std::string*, int);
 	
 	virtual uint8_t W1Reset(void);
 	virtual void	W1WriteByte(uint8_t);
 	virtual uint8_t W1ReadByte(void);
 	virtual uint8_t W1Triplet(uint8_t);
+	virtual uint8_t W1SingleBit(uint8_t);
+	virtual void	W1ReadBlock(uint8_t*, int);
 
 	virtual void 	SelectBus(Bus*);
 	virtual void 	SetOverdriveSpeed(bool);
+	virtual void 	SetActivePullup(bool);
+	virtual void 	ArmStrongPullup(void);
+
+	const char*		GetTransportName(void);
 	
 
   private:
+	void	StartW1Command(const int*);
 	uint8_t ReadRegUntilW1Idle(void);
-	uint8_t ReadByte(void);
+	uint8_t ReadRegister(uint8_t);
+	uint8_t GetConfigBits(void);
 	uint8_t CalculateConfig(uint8_t);
-	bool    SelectRegister(uint8_t);
+	bool    WriteConfig(uint8_t);
 	bool    SendCmd(uint8_t);
 	bool    SendCmdWithData(uint8_t, uint8_t);
-
-	int masterFd;
+	void    AfterCmd(uint8_t, uint8_t, bool);
+
+	Transport* transport;
+	bool overdrive;
+	bool activePullup;
+	bool strongPullup;
+	uint8_t readPtr;
+	int config;
+	std::chrono::steady_clock::time_point w1IdleAt;
 };
 
 
@@ -14,4 +14,9 @@ static inline int ioctl(int fd, int base, int address){
 }
 
 
+static inline int close(int fd){
+	return -1;
+}
+
+
 #endif
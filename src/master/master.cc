@@ -1,13 +1,37 @@
 #include "master.h"
 #include <iostream>
 #include <stdio.h>
+#include <stdarg.h>
 #include <string>
 
+#define MAX_ERROR_MSG_LEN 100
+
 Master::Master(std::string* name)
 	:name(*name), selectedBus(NULL)
 {};
 
 
+Master::~Master(void){
+	std::vector<Bus*>::iterator it;
+
+	for(it = buses.begin(); it != buses.end(); it++)
+		delete *it;
+}
+
+
+//Byte by byte by default, masters may transfer blocks faster
+void Master::W1WriteBlock(const uint8_t* bytes, int length){
+	for (int i=0; i<length; i++)
+		W1WriteByte(bytes[i]);
+}
+
+
+void Master::W1ReadBlock(uint8_t* bytes, int length){
+	for (int i=0; i<length; i++)
+		bytes[i] = W1ReadByte();
+}
+
+
 std::string* Master::GetName(void){
 	return &name;
 }
@@ -42,3 +66,35 @@ Bus* Master::GetSelectedBus(void){
 	return selectedBus;
 }
 
+
+const char* Master::GetError(void){
+	return error.c_str();
+}
+
+
+//Counters of the master itself, the bus counters are kept by each bus
+Statistics* Master::GetStatistics(void){
+	return &statistics;
+}
+
+
+//Latencies of one primitive, see PRIM_...
+Histogram* Master::GetLatencies(int primitive){
+	return &latencies[primitive];
+}
+
+
+//Errors are kept instead of thrown, masters may run outside the V8 thread
+void Master::SetErrorIf(bool isError, const char* format, ...){
+
+	if (isError){
+		char msg[MAX_ERROR_MSG_LEN+1];
+		va_list args;
+		va_start(args, format);
+		vsnprintf(msg, MAX_ERROR_MSG_LEN, format, args);
+		va_end(args);
+		error = msg;
+	}
+
+}
+
@@ -2,22 +2,43 @@
 #define MASTER_H
 
 #include "bus/bus.h"
+#include "statistics.h"
+#include "../shared/histogram.h"
 #include <vector>
 #include <stdint.h>
 #include <string>
 
+//Primitives with latency histograms
+#define PRIM_W1_RESET			0
+#define PRIM_W1_WRITE_BYTE		1
+#define PRIM_W1_READ_BYTE		2
+#define PRIM_W1_WRITE_BLOCK		3
+#define PRIM_W1_READ_BLOCK		4
+#define PRIM_W1_TRIPLET			5
+#define PRIM_SELECT_BUS			6
+#define PRIM_W1_SINGLE_BIT		7
+#define PRIM_COUNT				8
+
+
 class Master {
 
   public:
 	Master(std::string*);
+	virtual ~Master(void);
 
 	virtual void 	W1WriteByte(uint8_t) 	= 0;
 	virtual uint8_t W1ReadByte(void)	 	= 0;
 	virtual uint8_t W1Triplet(uint8_t)   	= 0;
 	virtual uint8_t W1Reset(void)        	= 0;
+	virtual uint8_t W1SingleBit(uint8_t)	= 0;
+
+	virtual void	W1WriteBlock(const uint8_t*, int);
+	virtual void	W1ReadBlock(uint8_t*, int);
 
 	virtual void 	SelectBus(Bus*)    	 	= 0;
 	virtual void 	SetOverdriveSpeed(bool) = 0;
+	virtual void 	SetActivePullup(bool)   = 0;
+	virtual void 	ArmStrongPullup(void)   = 0;
 
 	std::string* GetName(void);
 
@@ -28,13 +49,22 @@ class Master {
 	void SetSelectedBus(Bus*);
 	Bus* GetSelectedBus(void);
 
+	const char* GetError(void);
+	Statistics* GetStatistics(void);
+	Histogram*  GetLatencies(int);
+
 	
   protected:
 	void AddBus();
+	void SetErrorIf(bool, const char*, ...);
+
+	Statistics statistics;
+	Histogram  latencies[PRIM_COUNT];
 
   private:
 	std::vector<Bus*> buses;
 	std::string name;
+	std::string error;
 	Bus* selectedBus;
 
 };
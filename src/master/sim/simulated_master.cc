@@ -0,0 +1,96 @@
+#include "simulated_master.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+
+SimulatedMaster::SimulatedMaster(std::string* name, int busCount) : Master(name), overdrive(false) {
+
+	for (int i=0; i<busCount; i++){
+		AddBus();
+		wires.push_back(new VirtualWire());
+	}
+
+	for (int i=0; i<4; i++)
+		latencies[i] = 0;
+
+	selectedWire = wires.front();
+}
+
+
+SimulatedMaster::~SimulatedMaster(void){
+	std::vector<VirtualWire*>::iterator it;
+
+	for (it = wires.begin(); it != wires.end(); ++it)
+		delete *it;
+}
+
+
+uint8_t SimulatedMaster::W1Reset(void){
+	Wait(LAT_RESET);
+	return selectedWire->Reset();
+}
+
+
+void SimulatedMaster::W1WriteByte(uint8_t byte){
+	Wait(LAT_BYTE);
+	selectedWire->WriteByte(byte);
+}
+
+
+uint8_t SimulatedMaster::W1ReadByte(void){
+	Wait(LAT_BYTE);
+	return selectedWire->ReadByte();
+}
+
+
+uint8_t SimulatedMaster::W1Triplet(uint8_t dbit){
+	Wait(LAT_TRIPLET);
+	return selectedWire->Triplet(dbit);
+}
+
+
+//Bit slots have no latency of their own
+uint8_t SimulatedMaster::W1SingleBit(uint8_t bit){
+	return bit ? selectedWire->ReadBit() : 0;
+}
+
+
+void SimulatedMaster::SelectBus(Bus* bus){
+	Wait(LAT_SELECT);
+	selectedWire = wires.at(bus->GetNumber());
+	selectedWire->SetOverdriveSpeed(overdrive);
+}
+
+
+void SimulatedMaster::SetOverdriveSpeed(bool enabled){
+	overdrive = enabled;
+	selectedWire->SetOverdriveSpeed(enabled);
+}
+
+
+//Virtual wires are always powered, pullups change nothing
+void SimulatedMaster::SetActivePullup(bool){}
+
+
+void SimulatedMaster::ArmStrongPullup(void){}
+
+
+std::vector<VirtualWire*>* SimulatedMaster::GetWires(void){
+	return &wires;
+}
+
+
+void SimulatedMaster::SetLatency(int command, int microseconds){
+	latencies[command] = microseconds;
+}
+
+
+//private
+
+void SimulatedMaster::Wait(int command){
+	if (latencies[command] > 0)
+		std::this_thread::sleep_for(std::chrono::microseconds(latencies[command]));
+}
@@ -0,0 +1,49 @@
+#ifndef SIMULATED_MASTER_H
+#define SIMULATED_MASTER_H
+
+#include "../master.h"
+#include "virtual_wire.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#define LAT_RESET		0
+#define LAT_BYTE		1
+#define LAT_TRIPLET		2
+#define LAT_SELECT		3
+
+
+// Master without hardware, each bus is a VirtualWire.
+// Latencies (us) per command are 0 by default.
+class SimulatedMaster : public Master {
+
+  public:
+	SimulatedMaster(std::string*, int);
+	~SimulatedMaster(void);
+
+	virtual uint8_t W1Reset(void);
+	virtual void	W1WriteByte(uint8_t);
+	virtual uint8_t W1ReadByte(void);
+	virtual uint8_t W1Triplet(uint8_t);
+	virtual uint8_t W1SingleBit(uint8_t);
+
+	virtual void 	SelectBus(Bus*);
+	virtual void 	SetOverdriveSpeed(bool);
+	virtual void 	SetActivePullup(bool);
+	virtual void 	ArmStrongPullup(void);
+
+	std::vector<VirtualWire*>* GetWires(void);
+	void			SetLatency(int, int);
+
+
+  private:
+	void Wait(int);
+
+	std::vector<VirtualWire*> wires;
+	VirtualWire* selectedWire;
+	bool overdrive;
+	int latencies[4];
+};
+
+
+#endif
@@ -0,0 +1,88 @@
+#include "virtual_device.h"
+#include "virtual_ds18b20.h"
+#include "virtual_ds18s20.h"
+#include "virtual_ds2408.h"
+#include "virtual_ds1961.h"
+#include "../../device/lib/crc.h"
+#include <stdint.h>
+#include <vector>
+
+
+VirtualDevice::VirtualDevice(uint64_t romId)
+	: romId(romId), overdrive(false), responseIdx(0)
+{}
+
+
+//Family code is the lowest byte of the ROM id
+VirtualDevice* VirtualDevice::New(uint64_t romId){
+
+	switch ((uint8_t) romId){
+		case 0x10: return new VirtualDs18s20(romId);
+		case 0x28: return new VirtualDs18b20(romId);
+		case 0x29: return new VirtualDs2408(romId);
+		case 0x33: return new VirtualDs1961(romId);
+	}
+
+	return new VirtualDevice(romId);
+}
+
+
+//Starts a new function command
+void VirtualDevice::Select(void){
+	received.clear();
+	response.clear();
+	crcBytes.clear();
+	responseIdx = 0;
+}
+
+
+void VirtualDevice::Write(uint8_t byte){
+	received.push_back(byte);
+	crcBytes.push_back(byte);
+	Receive();
+}
+
+
+//Idle line reads as 0xFF
+uint8_t VirtualDevice::Read(void){
+	return responseIdx < response.size() ? response[responseIdx++] : 0xFF;
+}
+
+
+uint64_t VirtualDevice::GetRomId(void){
+	return romId;
+}
+
+
+bool VirtualDevice::InOverdrive(void){
+	return overdrive;
+}
+
+
+void VirtualDevice::SetOverdrive(bool enabled){
+	overdrive = enabled && SupportsOverdrive();
+}
+
+
+//protected
+
+void VirtualDevice::Respond(uint8_t byte){
+	response.push_back(byte);
+	crcBytes.push_back(byte);
+}
+
+
+void VirtualDevice::Respond(const uint8_t* bytes, int length){
+	for (int i=0; i<length; i++)
+		Respond(bytes[i]);
+}
+
+
+//Inverted CRC16 over everything sent and received since the last CRC
+void VirtualDevice::RespondInvCrc16(void){
+	uint16_t crc16 = Crc::Build16Bit(crcBytes.data(), (uint8_t) crcBytes.size());
+
+	response.push_back(~((uint8_t) crc16));
+	response.push_back(~((uint8_t) (crc16 >> 8)));
+	crcBytes.clear();
+}
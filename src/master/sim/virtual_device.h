@@ -0,0 +1,52 @@
+#ifndef VIRTUAL_DEVICE_H
+#define VIRTUAL_DEVICE_H
+
+#include <stdint.h>
+#include <vector>
+
+
+// Slave on a simulated 1wire segment. Bytes written after the
+// ROM command are collected in "received", bytes for the master
+// are queued with Respond().
+class VirtualDevice {
+
+  public:
+	VirtualDevice(uint64_t);
+	virtual ~VirtualDevice(void){};
+
+	static VirtualDevice* New(uint64_t);
+
+	//Function commands, for overwrite
+	virtual void Receive(void){}
+	virtual bool SupportsOverdrive(void){return false;}
+	virtual bool HasAlarm(void){return false;}
+	virtual uint8_t ReadBit(void){return 1;}
+
+	void 	Select(void);
+	void 	Write(uint8_t);
+	uint8_t Read(void);
+
+	uint64_t GetRomId(void);
+	bool 	 InOverdrive(void);
+	void 	 SetOverdrive(bool);
+
+
+  protected:
+	void Respond(uint8_t);
+	void Respond(const uint8_t*, int);
+	void RespondInvCrc16(void);
+
+	std::vector<uint8_t> received;
+
+
+  private:
+	uint64_t romId;
+	bool overdrive;
+
+	std::vector<uint8_t> response;
+	std::vector<uint8_t> crcBytes;
+	unsigned int responseIdx;
+};
+
+
+#endif
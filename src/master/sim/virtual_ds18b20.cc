@@ -0,0 +1,120 @@
+#include "virtual_ds18b20.h"
+#include "../../device/lib/crc.h"
+#include <stdint.h>
+#include <math.h>
+#include <chrono>
+
+//COMMANDS
+#define CMD_CONVERT_T			0x44
+#define CMD_SCRATCHPAD_WRITE	0x4E
+#define CMD_SCRATCHPAD_READ		0xBE
+#define CMD_POWER_SUPPLY_READ	0xB4
+
+//SCRATCHPAD
+#define SIX_TEMP_LSB			0
+#define SIX_TEMP_MSB			1
+#define SIX_ALARM_HIGH			2
+#define SIX_ALARM_LOW			3
+#define SIX_CONFIG				4
+#define SIX_CRC8				8
+
+#define DEFAULT_TEMPERATURE		21.5
+
+//Typical conversion times in ms for 9..12bit, below the datasheet maximum
+static const int conversionTimes[4] = { 75, 150, 300, 600 };
+
+
+//Power-on state, 85C until the first conversion
+VirtualDs18b20::VirtualDs18b20(uint64_t romId)
+	: VirtualDevice(romId), temperature(DEFAULT_TEMPERATURE), alarm(false), convertedAt(std::chrono::steady_clock::now())
+{
+	const uint8_t powerOn[9] = { 0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0x00 };
+
+	for (int i=0; i<9; i++)
+		scratchpad[i] = powerOn[i];
+
+	BuildCrc8();
+}
+
+
+void VirtualDs18b20::Receive(void){
+
+	switch (received[0]){
+		case CMD_CONVERT_T:
+			if (received.size() == 1){
+				Convert();
+				UpdateAlarm();
+				convertedAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(GetConversionTime());
+			}
+			break;
+
+		case CMD_SCRATCHPAD_READ:
+			if (received.size() == 1) Respond(scratchpad, 9);
+			break;
+
+		case CMD_POWER_SUPPLY_READ:
+			if (received.size() == 1) Respond(0xFF); //external supply
+			break;
+
+		//TH, TL, CONFIG
+		case CMD_SCRATCHPAD_WRITE:
+			if (received.size() == 4){
+				scratchpad[2] = received[1];
+				scratchpad[3] = received[2];
+				scratchpad[SIX_CONFIG] = received[3] | 0x1F;
+				BuildCrc8();
+			}
+			break;
+	}
+
+}
+
+
+//Read slots are 0 while converting. The new value is in the
+//scratchpad at once, only the duration is simulated.
+uint8_t VirtualDs18b20::ReadBit(void){
+	return std::chrono::steady_clock::now() < convertedAt ? 0 : 1;
+}
+
+
+void VirtualDs18b20::SetTemperature(double celsius){
+	temperature = celsius;
+}
+
+
+//Set by the last conversion, answers the alarm search
+bool VirtualDs18b20::HasAlarm(void){
+	return alarm;
+}
+
+
+//protected
+
+//Undefined bits of lower resolutions are zero
+void VirtualDs18b20::Convert(void){
+
+	int resolution = 9 + ((scratchpad[SIX_CONFIG] >> 5) & 0x03);
+	int16_t raw = (int16_t) floor(temperature * 16);
+	raw &= ~((1 << (12 - resolution)) - 1);
+
+	scratchpad[SIX_TEMP_LSB] = (uint8_t) raw;
+	scratchpad[SIX_TEMP_MSB] = (uint8_t) (raw >> 8);
+	BuildCrc8();
+}
+
+
+int VirtualDs18b20::GetConversionTime(void){
+	return conversionTimes[(scratchpad[SIX_CONFIG] >> 5) & 0x03];
+}
+
+
+void VirtualDs18b20::BuildCrc8(void){
+	scratchpad[SIX_CRC8] = Crc::Build8Bit(scratchpad, 8);
+}
+
+
+//Whole degrees are compared, like bits 11..4 of the DS18B20 register
+void VirtualDs18b20::UpdateAlarm(void){
+	int celsius = (int) floor(temperature);
+	alarm = celsius >= (int8_t) scratchpad[SIX_ALARM_HIGH] || celsius <= (int8_t) scratchpad[SIX_ALARM_LOW];
+}
@@ -0,0 +1,33 @@
+#ifndef VIRTUAL_DS18B20_H
+#define VIRTUAL_DS18B20_H
+
+#include "virtual_device.h"
+#include <stdint.h>
+#include <chrono>
+
+
+class VirtualDs18b20 : public VirtualDevice {
+
+  public:
+	VirtualDs18b20(uint64_t);
+
+	void Receive(void);
+	uint8_t ReadBit(void);
+	void SetTemperature(double);
+	bool HasAlarm(void);
+
+
+  protected:
+	virtual void Convert(void);
+	virtual int  GetConversionTime(void);
+	void BuildCrc8(void);
+	void UpdateAlarm(void);
+
+	uint8_t scratchpad[9];
+	double temperature;
+	bool alarm;
+	std::chrono::steady_clock::time_point convertedAt;
+};
+
+
+#endif
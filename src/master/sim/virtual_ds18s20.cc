@@ -0,0 +1,40 @@
+#include "virtual_ds18s20.h"
+#include <stdint.h>
+#include <math.h>
+
+//SCRATCHPAD
+#define SIX_TEMP_LSB		0
+#define SIX_TEMP_MSB		1
+#define SIX_COUNT_REMAIN	6
+#define SIX_COUNT_PER_C		7
+
+#define COUNT_PER_C			16
+
+
+VirtualDs18s20::VirtualDs18s20(uint64_t romId) : VirtualDs18b20(romId) {
+	scratchpad[SIX_TEMP_LSB] = 0xAA;
+	scratchpad[SIX_TEMP_MSB] = 0x00;
+	scratchpad[4] = 0xFF;
+	BuildCrc8();
+}
+
+
+//T = TEMP_READ - 0.25 + (COUNT_PER_C - COUNT_REMAIN) / COUNT_PER_C
+void VirtualDs18s20::Convert(void){
+
+	double tempRead = floor(temperature + 0.25);
+	int16_t raw = (int16_t) (tempRead * 2);
+	int countRemain = COUNT_PER_C - (int) floor((temperature - tempRead + 0.25) * COUNT_PER_C);
+
+	scratchpad[SIX_TEMP_LSB] 	 = (uint8_t) raw;
+	scratchpad[SIX_TEMP_MSB] 	 = (uint8_t) (raw >> 8);
+	scratchpad[SIX_COUNT_REMAIN] = (uint8_t) countRemain;
+	scratchpad[SIX_COUNT_PER_C]  = COUNT_PER_C;
+	BuildCrc8();
+}
+
+
+//No resolution setting, always like 12bit
+int VirtualDs18s20::GetConversionTime(void){
+	return 600;
+}
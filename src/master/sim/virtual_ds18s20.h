@@ -0,0 +1,21 @@
+#ifndef VIRTUAL_DS18S20_H
+#define VIRTUAL_DS18S20_H
+
+#include "virtual_ds18b20.h"
+#include <stdint.h>
+
+
+// Same commands as the DS18B20, 0.5C register plus COUNT_REMAIN
+class VirtualDs18s20 : public VirtualDs18b20 {
+
+  public:
+	VirtualDs18s20(uint64_t);
+
+
+  protected:
+	void Convert(void);
+	int  GetConversionTime(void);
+};
+
+
+#endif
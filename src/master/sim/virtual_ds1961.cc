@@ -0,0 +1,145 @@
+#include "virtual_ds1961.h"
+#include "../../device/ds1961.h"
+#include <stdint.h>
+#include <string.h>
+
+//COMMANDS
+#define CMD_WRITE_SCRATCHPAD     0x0F
+#define CMD_COPY_SCRATCHPAD      0x55
+#define CMD_LOAD_FIRST_SECRET    0x5A
+#define CMD_REFRESH_SCRATCHPAD   0xA3
+#define CMD_READ_AUTH_PAGE       0xA5
+#define CMD_READ_SCRATCHPAD      0xAA
+#define CMD_READ_MEMORY          0xF0
+
+#define MEM_SECRET               0x80
+#define MEM_SIZE                 128
+#define PAGE_SIZE                32
+
+
+VirtualDs1961::VirtualDs1961(uint64_t romId)
+	: VirtualDevice(romId), targetAddress(0), endingOffset(0)
+{
+	memset(memory, 0, sizeof(memory));
+	memset(secret, 0, sizeof(secret));
+	memset(scratchpad, 0, sizeof(scratchpad));
+}
+
+
+void VirtualDs1961::Receive(void){
+
+	switch (received[0]){
+		case CMD_WRITE_SCRATCHPAD:
+		case CMD_REFRESH_SCRATCHPAD:
+			if (received.size() == 11) WriteScratchpad(received[0] == CMD_WRITE_SCRATCHPAD);
+			break;
+
+		case CMD_READ_SCRATCHPAD:
+			if (received.size() == 1) ReadScratchpad();
+			break;
+
+		case CMD_LOAD_FIRST_SECRET:
+			if (received.size() == 4) LoadFirstSecret();
+			break;
+
+		case CMD_COPY_SCRATCHPAD:
+			if (received.size() == 24) CopyScratchpad();
+			break;
+
+		case CMD_READ_AUTH_PAGE:
+			if (received.size() == 3) ReadAuthPage();
+			break;
+
+		case CMD_READ_MEMORY:
+			if (received.size() == 3) ReadMemory();
+			break;
+	}
+
+}
+
+
+//private
+
+void VirtualDs1961::WriteScratchpad(bool write){
+
+	if (write){
+		targetAddress = (received[2] << 8) | (received[1] & 0xF8);
+		endingOffset  = 0x07;
+		memcpy(scratchpad, &received[3], 8);
+	}
+
+	RespondInvCrc16();
+}
+
+
+void VirtualDs1961::ReadScratchpad(void){
+	Respond((uint8_t) targetAddress);
+	Respond((uint8_t) (targetAddress >> 8));
+	Respond(endingOffset);
+	Respond(scratchpad, 8);
+	RespondInvCrc16();
+}
+
+
+void VirtualDs1961::LoadFirstSecret(void){
+
+	bool success = AuthCodeMatches() && targetAddress == MEM_SECRET;
+
+	if (success)
+		memcpy(secret, scratchpad, 8);
+
+	Respond(success ? 0xAA : 0xFF);
+}
+
+
+void VirtualDs1961::CopyScratchpad(void){
+
+	bool success = AuthCodeMatches() && targetAddress < MEM_SIZE;
+
+	if (success)
+		memcpy(&memory[targetAddress], scratchpad, 8);
+
+	Respond(success ? 0xAA : 0xFF);
+}
+
+
+//Page data + 0xFF + CRC16, MAC + CRC16, status
+void VirtualDs1961::ReadAuthPage(void){
+
+	uint16_t address = (received[2] << 8) | received[1];
+	uint8_t page[PAGE_SIZE];
+	uint8_t mac[20];
+	uint8_t challenge[3];
+
+	if (address >= MEM_SIZE)
+		return;
+
+	memcpy(page, &memory[address & ~(PAGE_SIZE-1)], PAGE_SIZE);
+	memcpy(challenge, &scratchpad[4], 3);
+	Ds1961::CalcMacReadAuthPage(mac, GetRomId(), address, page, secret, challenge);
+
+	Respond(&memory[address], PAGE_SIZE - (address % PAGE_SIZE));
+	Respond(0xFF);
+	RespondInvCrc16();
+	Respond(mac, 20);
+	RespondInvCrc16();
+	Respond(0xAA);
+}
+
+
+void VirtualDs1961::ReadMemory(void){
+
+	uint16_t address = (received[2] << 8) | received[1];
+
+	if (address < MEM_SIZE)
+		Respond(&memory[address], MEM_SIZE - address);
+
+}
+
+
+bool VirtualDs1961::AuthCodeMatches(void){
+	return
+	  received[1] == (uint8_t) targetAddress &&
+	  received[2] == (uint8_t) (targetAddress >> 8) &&
+	  received[3] == endingOffset;
+}
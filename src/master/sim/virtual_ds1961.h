@@ -0,0 +1,36 @@
+#ifndef VIRTUAL_DS1961_H
+#define VIRTUAL_DS1961_H
+
+#include "virtual_device.h"
+#include <stdint.h>
+
+
+// SHA-1 EEPROM. The MAC of "copy scratchpad" is not verified,
+// authenticated page reads return the real MAC.
+class VirtualDs1961 : public VirtualDevice {
+
+  public:
+	VirtualDs1961(uint64_t);
+
+	void Receive(void);
+	bool SupportsOverdrive(void){return true;}
+
+
+  private:
+	void WriteScratchpad(bool);
+	void ReadScratchpad(void);
+	void LoadFirstSecret(void);
+	void CopyScratchpad(void);
+	void ReadAuthPage(void);
+	void ReadMemory(void);
+	bool AuthCodeMatches(void);
+
+	uint8_t memory[128];
+	uint8_t secret[8];
+	uint8_t scratchpad[8];
+	uint16_t targetAddress;
+	uint8_t endingOffset;
+};
+
+
+#endif
@@ -0,0 +1,93 @@
+#include "virtual_ds2408.h"
+#include <stdint.h>
+
+//COMMANDS
+#define CMD_PIO_READ 				0xF0
+#define CMD_CONDITIONAL_SREG_WRTIE  0xCC
+#define CMD_CHANNEL_ACCESS_WRITE	0x5A
+#define CMD_RESET_ACTIVITY_LATCHES	0xC3
+
+//REGISTERS (0x88 - 0x8F)
+#define REG_BASE_ADDRESS	0x88
+#define RIX_PIO_LOGIC		0
+#define RIX_PIO_OUTPUT		1
+#define RIX_PIO_ACTIVITY	2
+#define RIX_STATUS			5
+
+#define STATUS_VCC_POWERED	0x80
+
+
+VirtualDs2408::VirtualDs2408(uint64_t romId) : VirtualDevice(romId) {
+	const uint8_t powerOn[8] = { 0xFF, 0xFF, 0x00, 0x00, 0x00, STATUS_VCC_POWERED | 0x08, 0xFF, 0xFF };
+
+	for (int i=0; i<8; i++)
+		registers[i] = powerOn[i];
+}
+
+
+void VirtualDs2408::Receive(void){
+
+	switch (received[0]){
+		case CMD_PIO_READ:
+			if (received.size() == 3) ReadRegisters();
+			break;
+
+		case CMD_CONDITIONAL_SREG_WRTIE:
+			if (received.size() == 4) WriteRegister();
+			break;
+
+		case CMD_CHANNEL_ACCESS_WRITE:
+			if (received.size() == 3) AccessWrite();
+			break;
+
+		case CMD_RESET_ACTIVITY_LATCHES:
+			if (received.size() == 1){
+				registers[RIX_PIO_ACTIVITY] = 0x00;
+				Respond(0xAA);
+			}
+			break;
+	}
+
+}
+
+
+//private
+
+//From the target address up to the end of the register page + CRC16
+void VirtualDs2408::ReadRegisters(void){
+
+	int start = received[1] - REG_BASE_ADDRESS;
+
+	if (received[2] != 0x00 || start < 0 || start > 7)
+		return;
+
+	Respond(&registers[start], 8 - start);
+	RespondInvCrc16();
+}
+
+
+//Only the control/status register is writable here
+void VirtualDs2408::WriteRegister(void){
+
+	if (received[1] == REG_BASE_ADDRESS + RIX_STATUS && received[2] == 0x00)
+		registers[RIX_STATUS] = STATUS_VCC_POWERED | (received[3] & 0x0F);
+
+}
+
+
+void VirtualDs2408::AccessWrite(void){
+
+	uint8_t byte = received[1];
+
+	if ((uint8_t) ~received[2] != byte){
+		Respond(0xFF);
+		return;
+	}
+
+	registers[RIX_PIO_ACTIVITY] |= registers[RIX_PIO_LOGIC] ^ byte;
+	registers[RIX_PIO_OUTPUT] = byte;
+	registers[RIX_PIO_LOGIC]  = byte;
+
+	Respond(0xAA);
+	Respond(registers[RIX_PIO_LOGIC]);
+}
@@ -0,0 +1,27 @@
+#ifndef VIRTUAL_DS2408_H
+#define VIRTUAL_DS2408_H
+
+#include "virtual_device.h"
+#include <stdint.h>
+
+
+// PIO pins follow the output latch, no external load
+class VirtualDs2408 : public VirtualDevice {
+
+  public:
+	VirtualDs2408(uint64_t);
+
+	void Receive(void);
+	bool SupportsOverdrive(void){return true;}
+
+
+  private:
+	void ReadRegisters(void);
+	void WriteRegister(void);
+	void AccessWrite(void);
+
+	uint8_t registers[8];
+};
+
+
+#endif
@@ -0,0 +1,274 @@
+#include "virtual_wire.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#define W1_MATCH_ROM    		  0x55
+#define W1_MATCH_ROM_OVERDRIVE    0x69
+#define W1_SKIP_ROM     		  0xCC
+#define W1_SKIP_ROM_OVERDRIVE     0x3C
+#define W1_RESUME     		  	  0xA5
+#define W1_SEARCH_ALL	 		  0xF0
+#define W1_SEARCH_ALARM	 		  0xEC
+
+#define PHASE_IDLE		0
+#define PHASE_ROM		1
+#define PHASE_MATCH		2
+#define PHASE_SEARCH	3
+#define PHASE_FUNCTION	4
+
+
+VirtualWire::VirtualWire(void)
+	: lastSelected(NULL), phase(PHASE_IDLE), romByteIdx(0), searchBitIdx(0),
+	  matchOverdrive(false), overdriveSpeed(false), matchRomId(0), counters()
+{}
+
+
+VirtualWire::~VirtualWire(void){
+	std::vector<VirtualDevice*>::iterator it;
+
+	for (it = devices.begin(); it != devices.end(); ++it)
+		delete *it;
+}
+
+
+void VirtualWire::AddDevice(VirtualDevice* device){
+	devices.push_back(device);
+}
+
+
+VirtualDevice* VirtualWire::GetDevice(uint64_t romId){
+	std::vector<VirtualDevice*>::iterator it;
+
+	for (it = devices.begin(); it != devices.end(); ++it){
+		if ((*it)->GetRomId() == romId)
+			return *it;
+	}
+
+	return NULL;
+}
+
+
+std::vector<VirtualDevice*>* VirtualWire::GetDevices(void){
+	return &devices;
+}
+
+
+//A reset in standard speed brings all devices back to standard speed.
+//Returns 0 on presence pulse, like Master::W1Reset.
+uint8_t VirtualWire::Reset(void){
+
+	bool presence = false;
+	std::vector<VirtualDevice*>::iterator it;
+	counters.resets++;
+
+	for (it = devices.begin(); it != devices.end(); ++it){
+		if (!overdriveSpeed)
+			(*it)->SetOverdrive(false);
+
+		presence |= Responds(*it);
+	}
+
+	selected.clear();
+	phase = PHASE_ROM;
+
+	return presence ? 0 : 1;
+}
+
+
+void VirtualWire::WriteByte(uint8_t byte){
+
+	std::vector<VirtualDevice*>::iterator it;
+	counters.bytesWritten++;
+
+	switch (phase){
+		case PHASE_ROM:
+			RomCommand(byte);
+			break;
+
+		case PHASE_MATCH:
+			MatchRomByte(byte);
+			break;
+
+		case PHASE_FUNCTION:
+			for (it = selected.begin(); it != selected.end(); ++it)
+				(*it)->Write(byte);
+			break;
+	}
+
+}
+
+
+uint8_t VirtualWire::ReadByte(void){
+
+	uint8_t byte = 0xFF;
+	std::vector<VirtualDevice*>::iterator it;
+	counters.bytesRead++;
+
+	if (phase == PHASE_FUNCTION){
+		for (it = selected.begin(); it != selected.end(); ++it)
+			byte &= (*it)->Read();
+	}
+
+	return byte;
+}
+
+
+//Read slot, devices may pull the line low
+uint8_t VirtualWire::ReadBit(void){
+
+	uint8_t bit = 1;
+	std::vector<VirtualDevice*>::iterator it;
+
+	if (phase == PHASE_FUNCTION){
+		for (it = selected.begin(); it != selected.end(); ++it)
+			bit &= (*it)->ReadBit();
+	}
+
+	return bit;
+}
+
+
+//Returns the DS2482 status bits SBR, TSB and DIR as bit 0, 1 and 2
+uint8_t VirtualWire::Triplet(uint8_t dbit){
+
+	uint8_t idBit = 1, cmpBit = 1, dir;
+	std::vector<VirtualDevice*> remaining;
+	std::vector<VirtualDevice*>::iterator it;
+	counters.triplets++;
+
+	if (phase != PHASE_SEARCH || searchBitIdx > 63)
+		return 0x03;
+
+	for (it = selected.begin(); it != selected.end(); ++it){
+		uint8_t bit = ((*it)->GetRomId() >> searchBitIdx) & 0x01;
+		idBit  &= bit;
+		cmpBit &= !bit;
+	}
+
+	dir = (idBit != cmpBit) ? idBit : (dbit ? 1 : 0);
+
+	for (it = selected.begin(); it != selected.end(); ++it){
+		if ((((*it)->GetRomId() >> searchBitIdx) & 0x01) == dir)
+			remaining.push_back(*it);
+	}
+
+	selected = remaining;
+	searchBitIdx++;
+
+	if (searchBitIdx == 64 && selected.size() == 1)
+		lastSelected = selected.front();
+
+	return idBit | (cmpBit << 1) | (dir << 2);
+}
+
+
+void VirtualWire::SetOverdriveSpeed(bool enabled){
+	overdriveSpeed = enabled;
+}
+
+
+WireCounters* VirtualWire::GetCounters(void){
+	return &counters;
+}
+
+
+//private
+
+void VirtualWire::RomCommand(uint8_t command){
+
+	std::vector<VirtualDevice*>::iterator it;
+
+	switch (command){
+		case W1_MATCH_ROM:
+		case W1_MATCH_ROM_OVERDRIVE:
+			phase 		   = PHASE_MATCH;
+			romByteIdx 	   = 0;
+			matchRomId 	   = 0;
+			matchOverdrive = (command == W1_MATCH_ROM_OVERDRIVE);
+			break;
+
+		case W1_SKIP_ROM:
+		case W1_SKIP_ROM_OVERDRIVE:
+			for (it = devices.begin(); it != devices.end(); ++it){
+				if (Responds(*it))
+					selected.push_back(*it);
+			}
+
+			for (it = selected.begin(); it != selected.end(); ++it){
+				if (command == W1_SKIP_ROM_OVERDRIVE)
+					(*it)->SetOverdrive(true);
+			}
+
+			SelectDevices();
+			break;
+
+		case W1_RESUME:
+			if (lastSelected != NULL && Responds(lastSelected))
+				selected.push_back(lastSelected);
+
+			SelectDevices();
+			break;
+
+		case W1_SEARCH_ALL:
+		case W1_SEARCH_ALARM:
+			for (it = devices.begin(); it != devices.end(); ++it){
+				if (Responds(*it) && (command == W1_SEARCH_ALL || (*it)->HasAlarm()))
+					selected.push_back(*it);
+			}
+
+			phase 		 = PHASE_SEARCH;
+			searchBitIdx = 0;
+			break;
+
+		default:
+			phase = PHASE_IDLE;
+	}
+
+}
+
+
+void VirtualWire::MatchRomByte(uint8_t byte){
+
+	matchRomId |= ((uint64_t) byte) << (romByteIdx * 8);
+
+	if (++romByteIdx < 8)
+		return;
+
+	VirtualDevice* device = GetDevice(matchRomId);
+
+	if (device != NULL && (matchOverdrive ? MatchesInOverdrive(device) : Responds(device))){
+		if (matchOverdrive)
+			device->SetOverdrive(true);
+
+		selected.push_back(device);
+	}
+
+	SelectDevices();
+}
+
+
+void VirtualWire::SelectDevices(void){
+	std::vector<VirtualDevice*>::iterator it;
+
+	for (it = selected.begin(); it != selected.end(); ++it)
+		(*it)->Select();
+
+	if (selected.size() == 1)
+		lastSelected = selected.front();
+
+	phase = PHASE_FUNCTION;
+}
+
+
+//Overdrive Match ROM is sent in standard speed, the ROM id follows in
+//overdrive. Devices already in overdrive take it as Match ROM.
+bool VirtualWire::MatchesInOverdrive(VirtualDevice* device){
+	return device->SupportsOverdrive() && overdriveSpeed;
+}
+
+
+//Devices only respond in their own speed
+bool VirtualWire::Responds(VirtualDevice* device){
+	return device->InOverdrive() == overdriveSpeed;
+}
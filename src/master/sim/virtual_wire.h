@@ -0,0 +1,61 @@
+#ifndef VIRTUAL_WIRE_H
+#define VIRTUAL_WIRE_H
+
+#include "virtual_device.h"
+#include <stdint.h>
+#include <vector>
+
+
+// Traffic on the wire, read by the benchmarks
+typedef struct {
+	uint64_t resets;
+	uint64_t bytesWritten;
+	uint64_t bytesRead;
+	uint64_t triplets;
+} WireCounters;
+
+
+// Simulated 1wire segment: ROM commands, search and overdrive.
+// Several responding devices are combined like on a real wired-AND line.
+class VirtualWire {
+
+  public:
+	VirtualWire(void);
+	~VirtualWire(void);
+
+	void AddDevice(VirtualDevice*);
+	VirtualDevice* GetDevice(uint64_t);
+	std::vector<VirtualDevice*>* GetDevices(void);
+
+	uint8_t Reset(void);
+	void 	WriteByte(uint8_t);
+	uint8_t ReadByte(void);
+	uint8_t ReadBit(void);
+	uint8_t Triplet(uint8_t);
+	void 	SetOverdriveSpeed(bool);
+
+	WireCounters* GetCounters(void);
+
+
+  private:
+	void RomCommand(uint8_t);
+	void MatchRomByte(uint8_t);
+	void SelectDevices(void);
+	bool Responds(VirtualDevice*);
+	bool MatchesInOverdrive(VirtualDevice*);
+
+	std::vector<VirtualDevice*> devices;
+	std::vector<VirtualDevice*> selected;
+	VirtualDevice* lastSelected;
+
+	int 	 phase;
+	int 	 romByteIdx;
+	int 	 searchBitIdx;
+	bool 	 matchOverdrive;
+	bool 	 overdriveSpeed;
+	uint64_t matchRomId;
+	WireCounters counters;
+};
+
+
+#endif
@@ -0,0 +1,53 @@
+#include "statistics.h"
+#include "../shared/histogram.h"
+#include <stdint.h>
+#include <chrono>
+
+
+Statistics::Statistics(void){
+	Reset();
+}
+
+
+void Statistics::Add(Statistics* other){
+	resets 		   += other->resets;
+	overdriveResets += other->overdriveResets;
+	bytesWritten   += other->bytesWritten;
+	bytesRead 	   += other->bytesRead;
+	triplets 	   += other->triplets;
+	channelSelects += other->channelSelects;
+	configWrites   += other->configWrites;
+	statusPolls    += other->statusPolls;
+	crcFailures    += other->crcFailures;
+	strongPullups  += other->strongPullups;
+	busyMicros 	   += other->busyMicros;
+}
+
+
+void Statistics::Reset(void){
+	resets 		   = 0;
+	overdriveResets = 0;
+	bytesWritten   = 0;
+	bytesRead 	   = 0;
+	triplets 	   = 0;
+	channelSelects = 0;
+	configWrites   = 0;
+	statusPolls    = 0;
+	crcFailures    = 0;
+	strongPullups  = 0;
+	busyMicros 	   = 0;
+}
+
+
+
+BusyTimer::BusyTimer(Statistics* statistics, Histogram* latencies)
+	: statistics(statistics), latencies(latencies), start(std::chrono::steady_clock::now())
+{}
+
+
+BusyTimer::~BusyTimer(void){
+	uint64_t micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+	statistics->busyMicros += micros;
+	latencies->Add(micros);
+}
@@ -0,0 +1,49 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include "../shared/histogram.h"
+#include <stdint.h>
+#include <chrono>
+
+
+// Counters of one master or bus. They are updated without locking,
+// a master is only used by one thread at a time.
+class Statistics {
+
+  public:
+	Statistics(void);
+
+	void Add(Statistics*);
+	void Reset(void);
+
+	uint64_t resets;
+	uint64_t overdriveResets;
+	uint64_t bytesWritten;
+	uint64_t bytesRead;
+	uint64_t triplets;
+	uint64_t channelSelects;
+	uint64_t configWrites;
+	uint64_t statusPolls;
+	uint64_t crcFailures;
+	uint64_t strongPullups;
+	uint64_t busyMicros;
+};
+
+
+// Adds its own lifetime to the busy time of the statistics
+// and to the latencies of the running primitive
+class BusyTimer {
+
+  public:
+	BusyTimer(Statistics*, Histogram*);
+	~BusyTimer(void);
+
+
+  private:
+	Statistics* statistics;
+	Histogram* latencies;
+	std::chrono::steady_clock::time_point start;
+};
+
+
+#endif
@@ -0,0 +1,269 @@
+#include "ds2482_emulator.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#define CMD_RESET				0xF0
+#define CMD_SET_READ_PTR		0xE1
+#define CMD_CHANNEL_SELECT		0xC3
+#define CMD_WRITE_CONFIG		0xD2
+
+#define CMD_W1_RESET			0xB4
+#define CMD_W1_SINGLE_BIT		0x87
+#define CMD_W1_WRITE_BYTE		0xA5
+#define CMD_W1_READ_BYTE		0x96
+#define CMD_W1_TRIPLET			0x78
+
+#define REG_STS_DIR				0x80
+#define REG_STS_TSB				0x40
+#define REG_STS_SBR				0x20
+#define REG_STS_RST				0x10
+#define REG_STS_SD				0x04
+#define REG_STS_PPD				0x02
+#define REG_STS_1WB				0x01
+#define REG_CFG_1WS				0x08
+#define REG_CFG_SPU				0x04
+
+#define PTR_CODE_STATUS			0xF0
+#define PTR_CODE_DATA			0xE1
+#define PTR_CODE_CHANNEL		0xD2
+#define PTR_CODE_CONFIG         0xC3
+
+
+//Nominal duration of the 1wire commands in us {standard, overdrive}
+static const int durW1Reset[2]		= { 1148, 146 };
+static const int durW1Bit[2]		= {   69,  11 };
+static const int durW1Byte[2]		= {  552,  88 };
+static const int durW1Triplet[2]	= {  207,  33 };
+
+//Channel codes for write/read
+static const uint8_t channelsWr[8] = { 0xF0, 0xE1, 0xD2, 0xC3, 0xB4, 0xA5, 0x96, 0x87 };
+static const uint8_t channelsRd[8] = { 0xB8, 0xB1, 0xAA, 0xA3, 0x9C, 0x95, 0x8E, 0x87 };
+
+
+
+Ds2482Emulator::Ds2482Emulator(int channelCount, bool timing) : timing(timing), transactions(0) {
+
+	for (int i=0; i<channelCount; i++)
+		wires.push_back(new VirtualWire());
+
+	Reset();
+}
+
+
+Ds2482Emulator::~Ds2482Emulator(void){
+	std::vector<VirtualWire*>::iterator it;
+
+	for (it = wires.begin(); it != wires.end(); ++it)
+		delete *it;
+}
+
+
+//No file is opened, the chip is always there
+int Ds2482Emulator::Open(std::string*, int){
+	return OPEN_SUCCESS;
+}
+
+
+bool Ds2482Emulator::Write(const uint8_t* bytes, int length){
+	transactions++;
+	return Execute(bytes[0], length > 1 ? bytes[1] : 0x00);
+}
+
+
+bool Ds2482Emulator::Read(uint8_t* value){
+
+	transactions++;
+
+	switch (readPtr){
+		case PTR_CODE_STATUS:  *value = GetStatus(); 			   break;
+		case PTR_CODE_DATA:	   *value = data;		 			   break;
+		case PTR_CODE_CHANNEL: *value = channelsRd[channel];	   break;
+		case PTR_CODE_CONFIG:  *value = config;		 			   break;
+	}
+
+	return true;
+}
+
+
+//Repeated start, counted as one transaction
+bool Ds2482Emulator::WriteRead(const uint8_t* bytes, int length, uint8_t* value){
+
+	bool success = Write(bytes, length) && Read(value);
+	transactions--;
+
+	return success;
+}
+
+
+const char* Ds2482Emulator::GetName(void){
+	return "emulator";
+}
+
+
+std::vector<VirtualWire*>* Ds2482Emulator::GetWires(void){
+	return &wires;
+}
+
+
+uint64_t Ds2482Emulator::GetTransactionCount(void){
+	return transactions;
+}
+
+
+//private
+
+//1wire commands are not acknowledged while the line is busy
+bool Ds2482Emulator::Execute(uint8_t cmd, uint8_t param){
+
+	bool overdrive = config & REG_CFG_1WS;
+	uint8_t result;
+
+	if (cmd == CMD_RESET){
+		Reset();
+		return true;
+	}
+
+	if (cmd == CMD_SET_READ_PTR)
+		return SetReadPointer(param);
+
+	if (IsBusy())
+		return false;
+
+	//1WS applies to every 1wire command, not only to the next reset
+	if (cmd != CMD_WRITE_CONFIG && cmd != CMD_CHANNEL_SELECT){
+		EndStrongPullup();
+		wire->SetOverdriveSpeed(overdrive);
+	}
+
+	switch (cmd){
+		case CMD_WRITE_CONFIG:
+			return WriteConfig(param);
+
+		case CMD_CHANNEL_SELECT:
+			return SelectChannel(param);
+
+		case CMD_W1_RESET:
+			status &= ~(REG_STS_PPD | REG_STS_SD);
+			status |= wire->Reset() == 0 ? REG_STS_PPD : 0x00;
+			StartW1Command(durW1Reset);
+			break;
+
+		//a write 0 slot reads 0 as well
+		case CMD_W1_SINGLE_BIT:
+			status &= ~REG_STS_SBR;
+			if ((param & 0x80) && wire->ReadBit())
+				status |= REG_STS_SBR;
+			StartW1Command(durW1Bit);
+			strongPullup = config & REG_CFG_SPU;
+			break;
+
+		case CMD_W1_WRITE_BYTE:
+			wire->WriteByte(param);
+			StartW1Command(durW1Byte);
+			strongPullup = config & REG_CFG_SPU;
+			break;
+
+		case CMD_W1_READ_BYTE:
+			data = wire->ReadByte();
+			StartW1Command(durW1Byte);
+			break;
+
+		case CMD_W1_TRIPLET:
+			result = wire->Triplet(param & 0x80);
+			status &= ~(REG_STS_SBR | REG_STS_TSB | REG_STS_DIR);
+			status |= result << 5;
+			StartW1Command(durW1Triplet);
+			break;
+
+		default:
+			return false;
+	}
+
+	readPtr = PTR_CODE_STATUS;
+	return true;
+}
+
+
+bool Ds2482Emulator::IsBusy(void){
+	return timing && std::chrono::steady_clock::now() < busyUntil;
+}
+
+
+void Ds2482Emulator::StartW1Command(const int* duration){
+	bool overdrive = config & REG_CFG_1WS;
+	busyUntil = std::chrono::steady_clock::now() + std::chrono::microseconds(duration[overdrive ? 1 : 0]);
+}
+
+
+//The pullup armed by SPU ends with the next 1wire command, SPU is cleared then
+void Ds2482Emulator::EndStrongPullup(void){
+
+	if (strongPullup)
+		config &= ~REG_CFG_SPU;
+
+	strongPullup = false;
+}
+
+
+uint8_t Ds2482Emulator::GetStatus(void){
+	return IsBusy() ? (status | REG_STS_1WB) : (status & ~REG_STS_1WB);
+}
+
+
+bool Ds2482Emulator::SetReadPointer(uint8_t ptrCode){
+
+	bool valid =
+	  ptrCode == PTR_CODE_STATUS || ptrCode == PTR_CODE_DATA ||
+	  ptrCode == PTR_CODE_CHANNEL || ptrCode == PTR_CODE_CONFIG;
+
+	if (valid)
+		readPtr = ptrCode;
+
+	return valid;
+}
+
+
+//Upper nibble must be the complement of the lower one.
+//Writing SPU as 0 ends a running strong pullup.
+bool Ds2482Emulator::WriteConfig(uint8_t value){
+
+	bool valid = ((value >> 4) ^ 0x0F) == (value & 0x0F);
+
+	if (valid){
+		strongPullup = strongPullup && (value & REG_CFG_SPU);
+		config   = value & 0x0F;
+		status  &= ~REG_STS_RST;
+		readPtr  = PTR_CODE_CONFIG;
+	}
+
+	return valid;
+}
+
+
+bool Ds2482Emulator::SelectChannel(uint8_t code){
+
+	for (uint8_t i=0; i<wires.size(); i++){
+		if (channelsWr[i] == code){
+			channel = i;
+			wire 	= wires[i];
+			readPtr = PTR_CODE_CHANNEL;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void Ds2482Emulator::Reset(void){
+	status 	  = REG_STS_RST;
+	data   	  = 0x00;
+	config 	  = 0x00;
+	strongPullup = false;
+	channel   = 0;
+	readPtr   = PTR_CODE_STATUS;
+	wire 	  = wires.front();
+	busyUntil = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,58 @@
+#ifndef DS2482_EMULATOR_H
+#define DS2482_EMULATOR_H
+
+#include "transport.h"
+#include "../sim/virtual_wire.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+
+// Register interface of a DS2482 in user space, the 1wire side of
+// each channel is a VirtualWire. With timing enabled, 1WB stays set
+// for the nominal duration of each 1wire command.
+class Ds2482Emulator : public Transport {
+
+  public:
+	Ds2482Emulator(int, bool);
+	~Ds2482Emulator(void);
+
+	virtual int  Open(std::string*, int);
+	virtual bool Write(const uint8_t*, int);
+	virtual bool Read(uint8_t*);
+	virtual bool WriteRead(const uint8_t*, int, uint8_t*);
+
+	virtual const char* GetName(void);
+
+	std::vector<VirtualWire*>* GetWires(void);
+	uint64_t GetTransactionCount(void);
+
+
+  private:
+	bool 	Execute(uint8_t, uint8_t);
+	bool 	IsBusy(void);
+	void 	StartW1Command(const int*);
+	void 	EndStrongPullup(void);
+	uint8_t GetStatus(void);
+	bool 	SetReadPointer(uint8_t);
+	bool 	WriteConfig(uint8_t);
+	bool 	SelectChannel(uint8_t);
+	void 	Reset(void);
+
+	std::vector<VirtualWire*> wires;
+	VirtualWire* wire;
+	bool timing;
+	bool strongPullup;
+
+	uint8_t status;
+	uint8_t data;
+	uint8_t config;
+	uint8_t channel;
+	uint8_t readPtr;
+	uint64_t transactions;
+	std::chrono::steady_clock::time_point busyUntil;
+};
+
+
+#endif
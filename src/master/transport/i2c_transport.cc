@@ -0,0 +1,60 @@
+#include "i2c_transport.h"
+#include <string>
+
+#ifndef _WIN32
+	#include <sys/ioctl.h>
+	#include "../lib/i2c-dev-linux.h"
+#endif
+
+
+
+I2cTransport::I2cTransport(void) : SmbusTransport(), combined(false) {}
+
+
+int I2cTransport::Open(std::string* devFile, int devAddress){
+
+	int result = SmbusTransport::Open(devFile, devAddress);
+
+#ifndef _WIN32
+	unsigned long funcs = 0;
+
+	if (result == OPEN_SUCCESS)
+		combined = ioctl(fd, I2C_FUNCS, &funcs) != -1 && (funcs & I2C_FUNC_I2C);
+#endif
+
+	return result;
+}
+
+
+bool I2cTransport::WriteRead(const uint8_t* bytes, int length, uint8_t* value){
+
+	if (!combined)
+		return SmbusTransport::WriteRead(bytes, length, value);
+
+#ifdef _WIN32
+	return false;
+#else
+	struct i2c_msg msgs[2];
+	struct i2c_rdwr_ioctl_data transfer;
+
+	msgs[0].addr  = address;
+	msgs[0].flags = 0;
+	msgs[0].len   = length;
+	msgs[0].buf   = (char*) bytes;
+
+	msgs[1].addr  = address;
+	msgs[1].flags = I2C_M_RD;
+	msgs[1].len   = 1;
+	msgs[1].buf   = (char*) value;
+
+	transfer.msgs  = msgs;
+	transfer.nmsgs = 2;
+
+	return ioctl(fd, I2C_RDWR, &transfer) == 2;
+#endif
+}
+
+
+const char* I2cTransport::GetName(void){
+	return combined ? "i2c" : "smbus";
+}
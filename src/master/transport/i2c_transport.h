@@ -0,0 +1,29 @@
+#ifndef I2C_TRANSPORT_H
+#define I2C_TRANSPORT_H
+
+#include "smbus_transport.h"
+#include <stdint.h>
+#include <string>
+
+
+// Plain I2C messages via I2C_RDWR. A write and the following read
+// are sent as one transfer with repeated start, so it costs one
+// syscall instead of two. Falls back to SMBus calls if the adapter
+// does not support plain I2C.
+class I2cTransport : public SmbusTransport {
+
+  public:
+	I2cTransport(void);
+
+	virtual int  Open(std::string*, int);
+	virtual bool WriteRead(const uint8_t*, int, uint8_t*);
+
+	virtual const char* GetName(void);
+
+
+  private:
+	bool combined;
+};
+
+
+#endif
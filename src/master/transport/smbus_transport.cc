@@ -0,0 +1,67 @@
+#include "smbus_transport.h"
+#include <string>
+
+#ifdef _WIN32
+	#include "../lib/i2c-dev-win.h"
+	#include "../lib/io-win.h"
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/ioctl.h>
+	#include "../lib/i2c-dev-linux.h"
+#endif
+
+
+
+SmbusTransport::SmbusTransport(void) : fd(-1), address(0) {}
+
+
+SmbusTransport::~SmbusTransport(void){
+	if (fd != -1)
+		close(fd);
+}
+
+
+int SmbusTransport::Open(std::string* devFile, int devAddress){
+
+	address = devAddress;
+	fd = open(devFile->c_str(), O_RDWR);
+
+	if (fd == -1)
+		return OPEN_ERR_DEV_FILE;
+
+	if (ioctl(fd, I2C_SLAVE, address) == -1)
+		return OPEN_ERR_ADDRESS;
+
+	return OPEN_SUCCESS;
+}
+
+
+//One SMBus call per command, with or without data byte
+bool SmbusTransport::Write(const uint8_t* bytes, int length){
+
+	if (length == 1)
+		return i2c_smbus_write_byte(fd, bytes[0]) == 0;
+
+	return i2c_smbus_write_byte_data(fd, bytes[0], bytes[1]) == 0;
+}
+
+
+bool SmbusTransport::Read(uint8_t* value){
+	int result = i2c_smbus_read_byte(fd);
+	*value = (uint8_t) result;
+
+	return result >= 0;
+}
+
+
+bool SmbusTransport::WriteRead(const uint8_t* bytes, int length, uint8_t* value){
+	return Write(bytes, length) && Read(value);
+}
+
+
+const char* SmbusTransport::GetName(void){
+	return "smbus";
+}
@@ -0,0 +1,29 @@
+#ifndef SMBUS_TRANSPORT_H
+#define SMBUS_TRANSPORT_H
+
+#include "transport.h"
+#include <stdint.h>
+#include <string>
+
+
+class SmbusTransport : public Transport {
+
+  public:
+	SmbusTransport(void);
+	~SmbusTransport(void);
+
+	virtual int  Open(std::string*, int);
+	virtual bool Write(const uint8_t*, int);
+	virtual bool Read(uint8_t*);
+	virtual bool WriteRead(const uint8_t*, int, uint8_t*);
+
+	virtual const char* GetName(void);
+
+
+  protected:
+	int fd;
+	int address;
+};
+
+
+#endif
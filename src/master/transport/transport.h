@@ -0,0 +1,29 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <stdint.h>
+#include <string>
+
+#define OPEN_SUCCESS		0
+#define OPEN_ERR_DEV_FILE	1
+#define OPEN_ERR_ADDRESS	2
+
+
+// I2C access of a master chip
+class Transport {
+
+  public:
+	virtual ~Transport(void){};
+
+	virtual int  Open(std::string*, int) 				= 0;
+	virtual bool Write(const uint8_t*, int) 			= 0;
+	virtual bool Read(uint8_t*) 						= 0;
+
+	//Write followed by a one byte read
+	virtual bool WriteRead(const uint8_t*, int, uint8_t*) = 0;
+
+	virtual const char* GetName(void) 					= 0;
+};
+
+
+#endif
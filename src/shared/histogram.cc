@@ -0,0 +1,86 @@
+#include "histogram.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <chrono>
+
+
+Histogram::Histogram(void){
+	Reset();
+}
+
+
+void Histogram::Add(uint64_t micros){
+	buckets[Bucket(micros)]++;
+	count++;
+
+	if (micros > max)
+		max = micros;
+}
+
+
+void Histogram::Reset(void){
+
+	for (int i=0; i<HISTOGRAM_BUCKETS; i++)
+		buckets[i] = 0;
+
+	count = 0;
+	max   = 0;
+}
+
+
+//Percent 0..100, 0 if nothing was added
+uint64_t Histogram::Percentile(int percent){
+
+	uint64_t rank = (count * percent + 99) / 100;
+	uint64_t seen = 0;
+
+	if (count == 0)
+		return 0;
+
+	for (int i=0; i<HISTOGRAM_BUCKETS; i++){
+		seen += buckets[i];
+
+		if (seen >= rank && seen > 0){
+			uint64_t upperBound = (((uint64_t) 1) << i) - 1;
+			return upperBound < max ? upperBound : max;
+		}
+	}
+
+	return max;
+}
+
+
+uint64_t Histogram::GetCount(void){
+	return count;
+}
+
+
+uint64_t Histogram::GetMax(void){
+	return max;
+}
+
+
+//Bucket i holds values from 2^(i-1) to 2^i-1, the last one everything above
+int Histogram::Bucket(uint64_t micros){
+
+	int bucket = 0;
+
+	while (micros > 0 && bucket < HISTOGRAM_BUCKETS-1){
+		micros >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+
+
+LatencyTimer::LatencyTimer(Histogram* histogram)
+	: histogram(histogram), start(std::chrono::steady_clock::now())
+{}
+
+
+LatencyTimer::~LatencyTimer(void){
+	if (histogram != NULL)
+		histogram->Add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
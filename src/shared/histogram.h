@@ -0,0 +1,48 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+#include <chrono>
+
+#define HISTOGRAM_BUCKETS 40
+
+
+// Latencies in us, counted in power of two buckets. Adding a value is
+// a few instructions, percentiles are the upper bound of their bucket
+// and never above the maximum.
+class Histogram {
+
+  public:
+	Histogram(void);
+
+	void 	 Add(uint64_t);
+	void 	 Reset(void);
+	uint64_t Percentile(int);
+	uint64_t GetCount(void);
+	uint64_t GetMax(void);
+
+
+  private:
+	static int Bucket(uint64_t);
+
+	uint64_t buckets[HISTOGRAM_BUCKETS];
+	uint64_t count;
+	uint64_t max;
+};
+
+
+// Adds its own lifetime to a histogram, nothing if there is none
+class LatencyTimer {
+
+  public:
+	LatencyTimer(Histogram*);
+	~LatencyTimer(void);
+
+
+  private:
+	Histogram* histogram;
+	std::chrono::steady_clock::time_point start;
+};
+
+
+#endif
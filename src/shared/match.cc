@@ -3,11 +3,14 @@
 #include <stdint.h>
 #include <algorithm>
 #include <cstring>
+#include <stdlib.h>
 
 
 static pattern patterns[] = {
   {MP_HEX_BYTE,   Match::HexByte},
-  {MP_PORT_VALUE, Match::PortValue}
+  {MP_PORT_VALUE, Match::PortValue},
+  {MP_DEVICE_ID,  Match::DeviceId},
+  {MP_CELSIUS,    Match::Celsius}
 };
 
 
@@ -58,11 +61,35 @@ bool Match::PortValue(const char* value){
 }
 
 
+//Upper case, like the ids returned by sync
+bool Match::DeviceId(const char* value){
+
+	bool match = strlen(value) == 16;
+
+	for (int i = 0; match && i < 16; i++)
+		match = (value[i] >= 48 && value[i] <= 57) || (value[i] >= 65 && value[i] <= 70);
+
+	return match;
+}
+
+
+//Whole degrees in the range of the temperature sensors
+bool Match::Celsius(const char* value){
+
+	bool match = strlen(value) > 0 && strlen(value) <= 4;
+
+	for (int i = (value[0] == '-') ? 1 : 0; match && value[i] != 0; i++)
+		match = (value[i] >= 48 && value[i] <= 57);
+
+	return match && strcmp(value, "-") != 0 && atoi(value) >= -55 && atoi(value) <= 125;
+}
+
+
 //private
 
 
 int Match::GetPatternIdx(const char* matcher){
-  for (int i = 0; i < 2; i++){
+  for (int i = 0; i < 4; i++){
 	if (matcher == patterns[i].name)
 	  return i;
   }
@@ -7,6 +7,8 @@
 #define MP_ALL_VALUES ""
 #define MP_HEX_BYTE   "{0x??}"
 #define MP_PORT_VALUE "{p0-7,0|1}"
+#define MP_DEVICE_ID  "{16 hex digits}"
+#define MP_CELSIUS    "{-55..125}"
 
 
 
@@ -24,6 +26,8 @@ class Match {
 	static bool List(const char*, const char*);
 	static bool HexByte(const char*);
 	static bool PortValue(const char*);
+	static bool DeviceId(const char*);
+	static bool Celsius(const char*);
 
 
   private:
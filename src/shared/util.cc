@@ -5,6 +5,7 @@
 #include <stdint.h>
 #include <algorithm>
 #include <math.h>
+#include <stdlib.h>
 
 #define MAX_EXCEPTION_MSG_LEN 100
 
@@ -40,6 +41,20 @@ std::string Util::UInt64ToHexStr(uint64_t value){
 }
 
 
+//Reverse of UInt64ToHexStr, first byte is the lowest
+uint64_t Util::HexStrToUInt64(std::string* value){
+
+	uint64_t result = 0;
+
+	for (int i = 0; i < 8; i++){
+	   uint64_t byte = strtoul(value->substr(i*2, 2).c_str(), NULL, 16);
+	   result |= byte << i*8;
+	}
+
+	return result;
+}
+
+
 int Util::StrPartToInt(const char* str, int charCount){
 
 	int value = 0;
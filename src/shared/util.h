@@ -10,6 +10,7 @@ class Util {
   public:
     static void ThrowExceptionIf(bool, const char*, ...);
     static std::string UInt64ToHexStr(uint64_t);
+    static uint64_t HexStrToUInt64(std::string*);
 	static int StrPartToInt(const char*, int);
 
     static void SetBit(uint8_t*, uint8_t, bool);
@@ -17,6 +17,11 @@ int V8Helper::GetIntFromV8Object(Handle<Value> object, const char* key){
 }
 
 
+bool V8Helper::GetBoolFromV8Object(Handle<Value> object, const char* key){
+	return GetV8ValueFromV8Object(object, key)->BooleanValue();
+}
+
+
 Handle<Value> V8Helper::GetV8ValueFromV8Object(Handle<Value> object, const char* key){
 	return object->ToObject()->Get((Handle<String>) String::New(key));
 }
@@ -82,6 +87,8 @@ bool V8Helper::V8ValueIsFromDataType(Handle<Value> value, const char* key){
 	  (value->IsObject() && (key == (const char*) DT_OBJECT)) ||
 	  (value->IsArray()  && (key == (const char*) DT_ARRAY))  ||
 	  (value->IsString() && (key == (const char*) DT_STRING)) ||
-	  (value->IsNumber() && (key == (const char*) DT_NUMBER));
+	  (value->IsNumber() && (key == (const char*) DT_NUMBER)) ||
+	  (value->IsFunction() && (key == (const char*) DT_FUNCTION)) ||
+	  (value->IsBoolean() && (key == (const char*) DT_BOOLEAN));
 
 }
@@ -8,6 +8,8 @@
 #define DT_ARRAY  "Array"
 #define DT_STRING "String"
 #define DT_NUMBER "Number"
+#define DT_FUNCTION "Function"
+#define DT_BOOLEAN "Boolean"
 
 using namespace v8;
 
@@ -17,6 +19,7 @@ class V8Helper {
   public:
 	static std::string GetStdStringFromV8Object(Handle<Value>, const char*);
 	static int GetIntFromV8Object(Handle<Value>, const char*);
+	static bool GetBoolFromV8Object(Handle<Value>, const char*);
 	static Handle<Value> GetV8ValueFromV8Object(Handle<Value>, const char*);
 	static Handle<Array> GetV8ArrayFromV8Object(Handle<Value>, const char*);
 